@@ -0,0 +1,68 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <time.h>
+
+// Tiny helpers shared by the benchmarks, each benchmark is its own program
+
+namespace bench
+{
+
+inline double now_ms()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Keeps the compiler from optimizing a computed value away
+static volatile std::size_t sink;
+
+template <typename T>
+inline void keep(T const& value)
+{
+	sink = sink + static_cast<std::size_t>(value);
+}
+
+// Small deterministic generator so that every run sees the same keys
+class rng
+{
+	unsigned long long state_;
+
+  public:
+	/*Constructor*/ explicit rng(unsigned long long seed = 42) : state_(seed) { }
+
+	unsigned long long next()
+	{
+		state_ ^= state_ << 13;
+		state_ ^= state_ >> 7;
+		state_ ^= state_ << 17;
+		return state_;
+	}
+};
+
+// Element count from the first command line argument, or a default
+inline std::size_t size_arg(int argc, char **argv, std::size_t fallback)
+{
+	if (argc > 1)
+		return std::strtoul(argv[1], NULL, 10);
+	return fallback;
+}
+
+inline void header(char const *title, std::size_t n)
+{
+	std::printf("\n== %s (n = %lu) ==\n", title, static_cast<unsigned long>(n));
+}
+
+inline void row(char const *name, double ms, std::size_t n)
+{
+	std::printf("%-44s %10.2f ms %10.1f ns/op\n", name, ms, ms * 1e6 / n);
+}
+
+} // namespace bench
+
+#endif /* BENCH_HPP */
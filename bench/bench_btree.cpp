@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+#include "btree_map.hpp"
+
+// Lookup and scan throughput of the B-tree against the binary trees
+
+typedef ft::map<int, int>       ft_map;
+typedef ft::btree_map<int, int> ft_btree;
+typedef std::map<int, int>      std_map;
+typedef std::vector<int>        keys_t;
+
+template <typename Map>
+void fill(Map& m, keys_t const& keys)
+{
+	for (keys_t::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		m.insert(typename Map::value_type(*it, *it));
+}
+
+template <typename Map>
+double time_insert(keys_t const& keys)
+{
+	double start = bench::now_ms();
+	Map    m;
+
+	fill(m, keys);
+	bench::keep(m.size());
+	return bench::now_ms() - start;
+}
+
+// Probes come in random order so that every lookup starts cold
+template <typename Map>
+double time_find(Map const& m, keys_t const& probes)
+{
+	double      start = bench::now_ms();
+	std::size_t found = 0;
+
+	for (keys_t::const_iterator it = probes.begin(); it != probes.end(); ++it)
+		found += m.find(*it)->second;
+	bench::keep(found);
+	return bench::now_ms() - start;
+}
+
+template <typename Map>
+double time_lower_bound(Map const& m, keys_t const& probes)
+{
+	double      start = bench::now_ms();
+	std::size_t found = 0;
+
+	for (keys_t::const_iterator it = probes.begin(); it != probes.end(); ++it)
+		found += m.lower_bound(*it + 1) != m.end();
+	bench::keep(found);
+	return bench::now_ms() - start;
+}
+
+template <typename Map>
+double time_scan(Map const& m)
+{
+	double      start = bench::now_ms();
+	std::size_t sum   = 0;
+
+	for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+		sum += it->second;
+	bench::keep(sum);
+	return bench::now_ms() - start;
+}
+
+template <typename Map>
+void run(char const *name, keys_t const& keys, keys_t const& probes)
+{
+	char label[64];
+	Map  m;
+
+	std::sprintf(label, "%s insert", name);
+	bench::row(label, time_insert<Map>(keys), keys.size());
+	fill(m, keys);
+	std::sprintf(label, "%s find", name);
+	bench::row(label, time_find(m, probes), probes.size());
+	std::sprintf(label, "%s lower_bound", name);
+	bench::row(label, time_lower_bound(m, probes), probes.size());
+	std::sprintf(label, "%s scan", name);
+	bench::row(label, time_scan(m), keys.size());
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t n = bench::size_arg(argc, argv, 1000000);
+	keys_t      keys;
+	bench::rng  rng;
+
+	for (std::size_t i = 0; i < n; ++i)
+		keys.push_back(static_cast<int>(i * 2));
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(keys[i - 1], keys[rng.next() % i]);
+	keys_t probes(keys);
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(probes[i - 1], probes[rng.next() % i]);
+
+	bench::header("shuffled int keys", n);
+	run<ft_btree>("ft::btree_map", keys, probes);
+	run<ft_map>("ft::map", keys, probes);
+	run<std_map>("std::map", keys, probes);
+	return 0;
+}
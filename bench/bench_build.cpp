@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+
+// Building a map out of n elements: bulk construction against one insert per element
+
+typedef ft::map<int, int>              ft_map;
+typedef std::map<int, int>             std_map;
+typedef std::vector<ft::pair<int, int> > input_t;
+
+template <typename Map>
+double time_range_ctor(input_t const& input)
+{
+	double start = bench::now_ms();
+	Map    m(input.begin(), input.end());
+
+	bench::keep(m.size());
+	return bench::now_ms() - start;
+}
+
+template <typename Map>
+double time_insert_loop(input_t const& input)
+{
+	double start = bench::now_ms();
+	Map    m;
+
+	for (input_t::const_iterator it = input.begin(); it != input.end(); ++it)
+		m.insert(typename Map::value_type(it->first, it->second));
+	bench::keep(m.size());
+	return bench::now_ms() - start;
+}
+
+double time_assign_sorted(input_t const& input)
+{
+	ft_map m;
+	m[0] = 0;
+
+	double start = bench::now_ms();
+	m.assign_sorted(input.begin(), input.end());
+	bench::keep(m.size());
+	return bench::now_ms() - start;
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t n = bench::size_arg(argc, argv, 1000000);
+	input_t     sorted;
+	bench::rng  rng;
+
+	for (std::size_t i = 0; i < n; ++i)
+		sorted.push_back(ft::pair<int, int>(static_cast<int>(i), static_cast<int>(i)));
+	input_t shuffled(sorted);
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(shuffled[i - 1], shuffled[rng.next() % i]);
+
+	bench::header("sorted input", n);
+	bench::row("ft::map range constructor", time_range_ctor<ft_map>(sorted), n);
+	bench::row("ft::map assign_sorted", time_assign_sorted(sorted), n);
+	bench::row("ft::map insert loop", time_insert_loop<ft_map>(sorted), n);
+	bench::row("std::map insert loop", time_insert_loop<std_map>(sorted), n);
+
+	bench::header("shuffled input", n);
+	bench::row("ft::map range constructor (sort then build)", time_range_ctor<ft_map>(shuffled), n);
+	bench::row("ft::map insert loop", time_insert_loop<ft_map>(shuffled), n);
+	bench::row("std::map insert loop", time_insert_loop<std_map>(shuffled), n);
+	return 0;
+}
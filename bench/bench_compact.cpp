@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+#include "compact_map.hpp"
+
+// Footprint and lookup throughput of the compact layout against ft::map's nodes
+
+// Bytes currently allocated, the containers rebind it to whatever they allocate
+static std::size_t live_bytes = 0;
+
+template <typename T>
+struct counting_allocator : std::allocator<T>
+{
+	template <typename U>
+	struct rebind
+	{
+		typedef counting_allocator<U> other;
+	};
+
+	/*Constructor*/ counting_allocator() { }
+
+	template <typename U>
+	/*Conversion*/ counting_allocator(counting_allocator<U> const&) { }
+
+	T *allocate(std::size_t n, void const * = 0)
+	{
+		live_bytes += n * sizeof(T);
+		return std::allocator<T>::allocate(n);
+	}
+
+	void deallocate(T *p, std::size_t n)
+	{
+		live_bytes -= n * sizeof(T);
+		std::allocator<T>::deallocate(p, n);
+	}
+};
+
+typedef unsigned int                                                    key_t_;
+typedef counting_allocator<std::pair<const key_t_, key_t_> >            alloc_t;
+typedef ft::map<key_t_, key_t_, std::less<key_t_>, alloc_t>             ft_map;
+typedef ft::compact_map<key_t_, key_t_, std::less<key_t_>, alloc_t>     ft_compact;
+typedef std::map<key_t_, key_t_, std::less<key_t_>, alloc_t>            std_map;
+typedef std::vector<key_t_>                                             keys_t;
+
+template <typename Map>
+void fill(Map& m, keys_t const& keys)
+{
+	for (keys_t::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		m.insert(typename Map::value_type(*it, *it));
+}
+
+// Probes come in random order so that every lookup starts cold
+template <typename Map>
+double time_find(Map const& m, keys_t const& probes)
+{
+	double      start = bench::now_ms();
+	std::size_t found = 0;
+
+	for (keys_t::const_iterator it = probes.begin(); it != probes.end(); ++it)
+		found += m.find(*it)->second;
+	bench::keep(found);
+	return bench::now_ms() - start;
+}
+
+template <typename Map>
+double time_count(Map const& m, keys_t const& probes)
+{
+	double      start = bench::now_ms();
+	std::size_t found = 0;
+
+	for (keys_t::const_iterator it = probes.begin(); it != probes.end(); ++it)
+		found += m.count(*it + 1);
+	bench::keep(found);
+	return bench::now_ms() - start;
+}
+
+template <typename Map>
+double time_scan(Map const& m)
+{
+	double      start = bench::now_ms();
+	std::size_t sum   = 0;
+
+	for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+		sum += it->second;
+	bench::keep(sum);
+	return bench::now_ms() - start;
+}
+
+template <typename Map>
+void run(char const *name, keys_t const& keys, keys_t const& probes)
+{
+	char        label[64];
+	std::size_t before = live_bytes;
+	double      start  = bench::now_ms();
+	Map         m;
+
+	fill(m, keys);
+	std::sprintf(label, "%s insert", name);
+	bench::row(label, bench::now_ms() - start, keys.size());
+	std::printf("%-44s %10.1f bytes/entry\n", name, double(live_bytes - before) / keys.size());
+	std::sprintf(label, "%s find", name);
+	bench::row(label, time_find(m, probes), probes.size());
+	std::sprintf(label, "%s count (misses)", name);
+	bench::row(label, time_count(m, probes), probes.size());
+	std::sprintf(label, "%s scan", name);
+	bench::row(label, time_scan(m), keys.size());
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t n = bench::size_arg(argc, argv, 1000000);
+	keys_t      keys;
+	bench::rng  rng;
+
+	for (std::size_t i = 0; i < n; ++i)
+		keys.push_back(static_cast<key_t_>(i * 2));
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(keys[i - 1], keys[rng.next() % i]);
+	keys_t probes(keys);
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(probes[i - 1], probes[rng.next() % i]);
+
+	bench::header("shuffled unsigned int keys and values", n);
+	run<ft_compact>("ft::compact_map", keys, probes);
+	run<ft_map>("ft::map", keys, probes);
+	run<std_map>("std::map", keys, probes);
+	return 0;
+}
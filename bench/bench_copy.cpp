@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+
+// Snapshotting a map: the structural copy against rebuilding it through insert
+
+// Counts the calls to allocate, the containers rebind it to whatever they allocate
+static std::size_t allocations = 0;
+
+template <typename T>
+struct counting_allocator : std::allocator<T>
+{
+	template <typename U>
+	struct rebind
+	{
+		typedef counting_allocator<U> other;
+	};
+
+	/*Constructor*/ counting_allocator() { }
+
+	template <typename U>
+	/*Conversion*/ counting_allocator(counting_allocator<U> const&) { }
+
+	T *allocate(std::size_t n, void const * = 0)
+	{
+		++allocations;
+		return std::allocator<T>::allocate(n);
+	}
+};
+
+typedef counting_allocator<std::pair<const int, int> > alloc_t;
+typedef ft::map<int, int, std::less<int>, alloc_t>     ft_map;
+typedef std::map<int, int, std::less<int>, alloc_t>    std_map;
+
+// What operator= used to do
+double time_insert_copy(ft_map const& m, std::size_t *allocated)
+{
+	std::size_t before = allocations;
+	double      start  = bench::now_ms();
+	ft_map      copy;
+
+	for (ft_map::const_iterator it = m.begin(); it != m.end(); ++it)
+		copy.insert(*it);
+	double ms = bench::now_ms() - start;
+	*allocated = allocations - before;
+	bench::keep(copy.size());
+	return ms;
+}
+
+template <typename Map>
+double time_range_copy(Map const& m, std::size_t *allocated)
+{
+	std::size_t before = allocations;
+	double      start  = bench::now_ms();
+	Map         copy(m.begin(), m.end());
+
+	double ms = bench::now_ms() - start;
+	*allocated = allocations - before;
+	bench::keep(copy.size());
+	return ms;
+}
+
+template <typename Map>
+double time_copy(Map const& m, std::size_t *allocated)
+{
+	std::size_t before = allocations;
+	double      start  = bench::now_ms();
+	Map         copy(m);
+
+	double ms = bench::now_ms() - start;
+	*allocated = allocations - before;
+	bench::keep(copy.size());
+	return ms;
+}
+
+void row(char const *name, double ms, std::size_t n, std::size_t allocated)
+{
+	char label[64];
+
+	std::sprintf(label, "%s, %lu allocations", name, static_cast<unsigned long>(allocated));
+	bench::row(label, ms, n);
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t n = bench::size_arg(argc, argv, 1000000);
+	bench::rng  rng;
+	ft_map      m;
+	std_map     s;
+	std::size_t allocated;
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		int key = static_cast<int>(rng.next() % (n * 4));
+		m.insert(ft_map::value_type(key, key));
+		s.insert(std_map::value_type(key, key));
+	}
+
+	bench::header("copying a map of random keys", m.size());
+	double ms = time_insert_copy(m, &allocated);
+	row("ft::map insert loop", ms, m.size(), allocated);
+	ms = time_range_copy(m, &allocated);
+	row("ft::map range constructor", ms, m.size(), allocated);
+	ms = time_copy(m, &allocated);
+	row("ft::map copy constructor", ms, m.size(), allocated);
+	ms = time_copy(s, &allocated);
+	row("std::map copy constructor", ms, s.size(), allocated);
+	return 0;
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+
+// Counting with operator[]: ft::map finds the insertion point once, lower_bound then a hinted insert is what it used to do
+
+// What operator[] used to do
+template <typename Map>
+typename Map::mapped_type& bracket_in_two(Map& m, typename Map::key_type const& key)
+{
+	typename Map::iterator it = m.lower_bound(key);
+
+	if (it == m.end() || m.key_comp()(key, it->first))
+		it = m.insert(it, typename Map::value_type(key, typename Map::mapped_type()));
+	return it->second;
+}
+
+// Counts every draw, distinct is how many different keys there are
+template <typename Map, typename Keys>
+void run(char const *name, Keys const& draws, std::size_t distinct, bool in_two)
+{
+	char label[64];
+	Map  m;
+
+	double start = bench::now_ms();
+	for (typename Keys::const_iterator it = draws.begin(); it != draws.end(); ++it)
+	{
+		if (in_two)
+			bracket_in_two(m, *it) += 1;
+		else
+			m[*it] += 1;
+	}
+	double elapsed = bench::now_ms() - start;
+	bench::keep(m.size());
+	std::sprintf(label, "%s, %lu keys", name, static_cast<unsigned long>(distinct));
+	bench::row(label, elapsed, draws.size());
+}
+
+// Paths that share a long prefix, so that every comparison reads well into the strings
+static std::string make_key(std::size_t i)
+{
+	char buf[64];
+
+	std::sprintf(buf, "/srv/data/shards/0000/objects/%010lu", static_cast<unsigned long>(i));
+	return buf;
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t n = bench::size_arg(argc, argv, 1000000);
+	bench::rng  rng;
+
+	std::size_t const distinct[] = { 1000, n / 10, n };
+	bench::header("counting unsigned keys with operator[], time per increment", n);
+	for (std::size_t i = 0; i < sizeof(distinct) / sizeof(*distinct); ++i)
+	{
+		std::vector<unsigned> draws;
+		for (std::size_t j = 0; j < n; ++j)
+			draws.push_back(static_cast<unsigned>(rng.next() % distinct[i]));
+		run<ft::map<unsigned, unsigned> >("ft::map, operator[]", draws, distinct[i], false);
+		run<ft::map<unsigned, unsigned> >("ft::map, lower_bound + insert", draws, distinct[i], true);
+		run<std::map<unsigned, unsigned> >("std::map, operator[]", draws, distinct[i], false);
+	}
+
+	bench::header("counting string keys with operator[], time per increment", n);
+	for (std::size_t i = 0; i < sizeof(distinct) / sizeof(*distinct); ++i)
+	{
+		std::vector<std::string> draws;
+		for (std::size_t j = 0; j < n; ++j)
+			draws.push_back(make_key(rng.next() % distinct[i]));
+		run<ft::map<std::string, unsigned> >("ft::map, operator[]", draws, distinct[i], false);
+		run<ft::map<std::string, unsigned> >("ft::map, lower_bound + insert", draws, distinct[i], true);
+		run<std::map<std::string, unsigned> >("std::map, operator[]", draws, distinct[i], false);
+	}
+	return 0;
+}
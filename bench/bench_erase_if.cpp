@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+
+// erase_if erasing one by one, rebuilding, and choosing between the two, by share of matches
+
+typedef std::vector<unsigned> keys_t;
+
+// Values are timestamps, the oldest per_mille thousandths of the entries are expired
+struct expired
+{
+	unsigned now;
+
+	template <typename Pair>
+	bool operator()(Pair const& entry) const { return entry.second < now; }
+};
+
+template <typename Map>
+void fill(Map& m, keys_t const& keys)
+{
+	for (std::size_t i = 0; i < keys.size(); ++i)
+		m.insert(typename Map::value_type(keys[i], static_cast<unsigned>(i)));
+}
+
+template <typename Map>
+std::size_t erase_each(Map& m, expired pred)
+{
+	std::size_t n = m.size();
+
+	for (typename Map::iterator it = m.begin(); it != m.end();)
+	{
+		if (pred(*it))
+			m.erase(it++);
+		else
+			++it;
+	}
+	return n - m.size();
+}
+
+std::size_t erase_expired(std::map<unsigned, unsigned>& m, expired pred, std::size_t)
+{
+	return erase_each(m, pred);
+}
+
+std::size_t erase_expired(ft::map<unsigned, unsigned>& m, expired pred, std::size_t rebuild_ratio)
+{
+	return m.erase_if(pred, rebuild_ratio);
+}
+
+template <typename Map>
+void run(char const *name, keys_t const& keys, std::size_t per_mille, std::size_t rebuild_ratio)
+{
+	char    label[64];
+	Map     m;
+	expired pred = { static_cast<unsigned>(keys.size() * per_mille / 1000) };
+
+	fill(m, keys);
+	double start = bench::now_ms();
+	bench::keep(erase_expired(m, pred, rebuild_ratio));
+	std::sprintf(label, "%s, %4.1f%% expired", name, per_mille / 10.0);
+	bench::row(label, bench::now_ms() - start, keys.size());
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t n = bench::size_arg(argc, argv, 1000000);
+	keys_t      keys;
+	bench::rng  rng;
+
+	for (std::size_t i = 0; i < n; ++i)
+		keys.push_back(static_cast<unsigned>(i));
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(keys[i - 1], keys[rng.next() % i]);
+
+	std::size_t const per_mille[] = { 1, 10, 30, 60, 100, 250, 500, 900 };
+	bench::header("erase_if, time per element in the map", n);
+	for (std::size_t i = 0; i < sizeof(per_mille) / sizeof(*per_mille); ++i)
+	{
+		run<ft::map<unsigned, unsigned> >("ft::map, one by one", keys, per_mille[i], 0);
+		run<ft::map<unsigned, unsigned> >("ft::map, rebuild", keys, per_mille[i], n + 1);
+		run<ft::map<unsigned, unsigned> >("ft::map, default", keys, per_mille[i], 4);
+		run<std::map<unsigned, unsigned> >("std::map", keys, per_mille[i], 0);
+	}
+	return 0;
+}
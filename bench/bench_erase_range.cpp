@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+
+// Erasing a range of k elements out of n: ft::map cuts out long ranges, erasing one by one is what it used to do
+
+typedef std::vector<unsigned> keys_t;
+
+template <typename Map>
+void fill(Map& m, keys_t const& keys)
+{
+	for (keys_t::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		m.insert(typename Map::value_type(*it, *it));
+}
+
+// What erase(first, last) used to do
+template <typename Map>
+void erase_each(Map& m, typename Map::iterator first, typename Map::iterator last)
+{
+	while (first != last)
+		m.erase(first++);
+}
+
+// Erases rounds ranges of k keys spread over the map, returns the time per erased element
+template <typename Map>
+void run(char const *name, keys_t const& keys, std::size_t k, bool each)
+{
+	char        label[64];
+	Map         m;
+	std::size_t rounds = std::min<std::size_t>(keys.size() / k / 2, 20000);
+	std::size_t stride = keys.size() / rounds;
+
+	fill(m, keys);
+	double start = bench::now_ms();
+	for (std::size_t r = 0; r < rounds; ++r)
+	{
+		typename Map::iterator first = m.lower_bound(static_cast<unsigned>(r * stride));
+		typename Map::iterator last  = m.lower_bound(static_cast<unsigned>(r * stride + k));
+		if (each)
+			erase_each(m, first, last);
+		else
+			m.erase(first, last);
+	}
+	double elapsed = bench::now_ms() - start;
+	bench::keep(m.size());
+	std::sprintf(label, "%s, k = %lu", name, static_cast<unsigned long>(k));
+	bench::row(label, elapsed, rounds * k);
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t n = bench::size_arg(argc, argv, 1000000);
+	keys_t      keys;
+	bench::rng  rng;
+
+	for (std::size_t i = 0; i < n; ++i)
+		keys.push_back(static_cast<unsigned>(i));
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(keys[i - 1], keys[rng.next() % i]);
+
+	std::size_t const sizes[] = { 1, 4, 16, 32, 64, 1000, n / 4, n / 2 };
+	bench::header("range erase, time per erased element", n);
+	for (std::size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i)
+	{
+		run<ft::map<unsigned, unsigned> >("ft::map, erase(first, last)", keys, sizes[i], false);
+		run<ft::map<unsigned, unsigned> >("ft::map, erase(it++)", keys, sizes[i], true);
+		run<std::map<unsigned, unsigned> >("std::map", keys, sizes[i], false);
+	}
+	return 0;
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+
+// find_batch() against a loop of find() calls, for batches of random keys
+// The small tree fits in the last level cache, the big one only in RAM
+
+typedef ft::map<int, int>          ft_map;
+typedef std::vector<int>           keys_t;
+typedef std::vector<ft_map::const_iterator> results_t;
+
+double time_find_loop(ft_map const& m, keys_t const& probes, std::size_t batch, results_t& out)
+{
+	double start = bench::now_ms();
+
+	for (std::size_t i = 0; i + batch <= probes.size(); i += batch)
+	{
+		for (std::size_t j = 0; j < batch; ++j)
+			out[j] = m.find(probes[i + j]);
+		bench::keep(out[batch - 1]->second);
+	}
+	return bench::now_ms() - start;
+}
+
+double time_find_batch(ft_map const& m, keys_t const& probes, std::size_t batch, results_t& out)
+{
+	double start = bench::now_ms();
+
+	for (std::size_t i = 0; i + batch <= probes.size(); i += batch)
+	{
+		m.find_batch(probes.begin() + i, probes.begin() + i + batch, out.begin());
+		bench::keep(out[batch - 1]->second);
+	}
+	return bench::now_ms() - start;
+}
+
+void run(std::size_t n, std::size_t lookups, bench::rng& rng)
+{
+	keys_t keys;
+	ft_map m;
+
+	// Shuffled inserts scatter neighbouring nodes all over the slabs
+	for (std::size_t i = 0; i < n; ++i)
+		keys.push_back(static_cast<int>(i));
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(keys[i - 1], keys[rng.next() % i]);
+	for (std::size_t i = 0; i < n; ++i)
+		m.insert(ft_map::value_type(keys[i], keys[i]));
+
+	keys_t probes;
+	for (std::size_t i = 0; i < lookups; ++i)
+		probes.push_back(static_cast<int>(rng.next() % n));
+
+	std::size_t const batches[] = { 64, 512 };
+	results_t         out(512);
+	char              label[64];
+
+	bench::header("random lookups in a map", n);
+	for (std::size_t b = 0; b < sizeof(batches) / sizeof(*batches); ++b)
+	{
+		std::sprintf(label, "find() loop, batches of %lu", static_cast<unsigned long>(batches[b]));
+		bench::row(label, time_find_loop(m, probes, batches[b], out), lookups);
+		std::sprintf(label, "find_batch(), batches of %lu", static_cast<unsigned long>(batches[b]));
+		bench::row(label, time_find_batch(m, probes, batches[b], out), lookups);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t lookups = bench::size_arg(argc, argv, 2000000);
+	bench::rng  rng;
+
+	run(1 << 16, lookups, rng); // About 3 MB of nodes
+	run(1 << 22, lookups, rng); // About 170 MB of nodes
+	return 0;
+}
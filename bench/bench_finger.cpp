@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+
+// Sorted batches of keys spread over a big map, looked up and inserted from the root each time
+// or by finger search from the previous one
+
+typedef ft::map<int, int>            ft_map;
+typedef std::vector<int>             keys_t;
+typedef std::vector<std::pair<int, int> > values_t;
+
+double time_find_loop(ft_map const& m, keys_t const& keys)
+{
+	double      start = bench::now_ms();
+	std::size_t found = 0;
+
+	for (keys_t::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		found += m.find(*it) != m.end();
+	bench::keep(found);
+	return bench::now_ms() - start;
+}
+
+double time_find_sorted_batch(ft_map const& m, keys_t const& keys)
+{
+	std::vector<ft_map::const_iterator> out(keys.size());
+	double start = bench::now_ms();
+
+	m.find_sorted_batch(keys.begin(), keys.end(), out.begin());
+	bench::keep(out.back() != m.end());
+	return bench::now_ms() - start;
+}
+
+// Only the insertions are timed, each run works on a fresh copy of the map
+double time_insert_loop(ft_map const& base, values_t const& values)
+{
+	ft_map m(base.begin(), base.end());
+	double start = bench::now_ms();
+
+	for (values_t::const_iterator it = values.begin(); it != values.end(); ++it)
+		m.insert(ft_map::value_type(it->first, it->second));
+	bench::keep(m.size());
+	return bench::now_ms() - start;
+}
+
+double time_insert_range(ft_map const& base, values_t const& values)
+{
+	ft_map m(base.begin(), base.end());
+	double start = bench::now_ms();
+
+	m.insert(values.begin(), values.end());
+	bench::keep(m.size());
+	return bench::now_ms() - start;
+}
+
+double time_insert_sorted_batch(ft_map const& base, values_t const& values)
+{
+	ft_map m(base.begin(), base.end());
+	double start = bench::now_ms();
+
+	m.insert_sorted_batch(values.begin(), values.end());
+	bench::keep(m.size());
+	return bench::now_ms() - start;
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t n = bench::size_arg(argc, argv, 1000000);
+	keys_t      shuffled;
+	bench::rng  rng;
+	ft_map      m;
+	char        label[64];
+
+	for (std::size_t i = 0; i < n; ++i)
+		shuffled.push_back(static_cast<int>(i * 2));
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(shuffled[i - 1], shuffled[rng.next() % i]);
+	for (std::size_t i = 0; i < n; ++i)
+		m.insert(ft_map::value_type(shuffled[i], shuffled[i]));
+
+	for (std::size_t batch = 1000; batch <= n; batch *= 10)
+	{
+		keys_t   keys;
+		values_t values;
+
+		// Every other key is there, new ones go in between
+		for (std::size_t i = 0; i < batch; ++i)
+			keys.push_back(static_cast<int>(rng.next() % (n * 2)));
+		std::sort(keys.begin(), keys.end());
+		for (std::size_t i = 0; i < batch; ++i)
+			values.push_back(std::make_pair(keys[i] | 1, keys[i]));
+
+		std::sprintf(label, "sorted batch of %lu keys", static_cast<unsigned long>(batch));
+		bench::header(label, n);
+		bench::row("find() loop", time_find_loop(m, keys), batch);
+		bench::row("find_sorted_batch()", time_find_sorted_batch(m, keys), batch);
+		bench::row("insert(value) loop", time_insert_loop(m, values), batch);
+		bench::row("insert(first, last), hinted", time_insert_range(m, values), batch);
+		bench::row("insert_sorted_batch()", time_insert_sorted_batch(m, values), batch);
+	}
+	return 0;
+}
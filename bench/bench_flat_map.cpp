@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+#include "btree_map.hpp"
+#include "flat_map.hpp"
+
+// Memory per entry and lookup time of the sorted arrays against the node based maps
+
+// Counts the bytes the containers hold, they all rebind it to whatever they allocate
+static std::size_t live_bytes = 0;
+
+template <typename T>
+struct counting_allocator : std::allocator<T>
+{
+	template <typename U>
+	struct rebind
+	{
+		typedef counting_allocator<U> other;
+	};
+
+	/*Constructor*/ counting_allocator() { }
+
+	template <typename U>
+	/*Conversion*/ counting_allocator(counting_allocator<U> const&) { }
+
+	T *allocate(std::size_t n, void const * = 0)
+	{
+		live_bytes += n * sizeof(T);
+		return std::allocator<T>::allocate(n);
+	}
+
+	void deallocate(T *p, std::size_t n)
+	{
+		live_bytes -= n * sizeof(T);
+		std::allocator<T>::deallocate(p, n);
+	}
+};
+
+typedef counting_allocator<std::pair<const int, int> >             alloc_t;
+typedef ft::flat_map<int, int, std::less<int>, alloc_t>             ft_flat;
+typedef ft::map<int, int, std::less<int>, alloc_t>                  ft_map;
+typedef ft::btree_map<int, int, std::less<int>, alloc_t>            ft_btree;
+typedef std::map<int, int, std::less<int>, alloc_t>                 std_map;
+typedef std::vector<int>        keys_t;
+
+template <typename Map>
+void fill(Map& m, std::vector<ft::pair<int, int> > const& entries)
+{
+	m.insert(entries.begin(), entries.end());
+}
+
+// std::map only takes its own pair
+void fill(std_map& m, std::vector<ft::pair<int, int> > const& entries)
+{
+	for (std::size_t i = 0; i < entries.size(); ++i)
+		m.insert(std_map::value_type(entries[i].first, entries[i].second));
+}
+
+template <typename Map>
+double time_find(Map const& m, keys_t const& probes)
+{
+	double      start = bench::now_ms();
+	std::size_t found = 0;
+
+	for (keys_t::const_iterator it = probes.begin(); it != probes.end(); ++it)
+		found += m.find(*it)->second;
+	bench::keep(found);
+	return bench::now_ms() - start;
+}
+
+template <typename Map>
+void run(char const *name, std::vector<ft::pair<int, int> > const& entries, keys_t const& probes)
+{
+	char        label[64];
+	std::size_t before = live_bytes;
+	double      start  = bench::now_ms();
+	Map         m;
+
+	fill(m, entries);
+	double load = bench::now_ms() - start;
+	std::printf("%-32s %8.1f bytes/entry\n", name, double(live_bytes - before) / entries.size());
+	std::sprintf(label, "%s bulk load", name);
+	bench::row(label, load, entries.size());
+	std::sprintf(label, "%s find", name);
+	bench::row(label, time_find(m, probes), probes.size());
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t                       n = bench::size_arg(argc, argv, 1000000);
+	std::vector<ft::pair<int, int> > entries;
+	keys_t                            probes;
+	bench::rng                        rng;
+
+	for (std::size_t i = 0; i < n; ++i)
+		probes.push_back(static_cast<int>(i * 2));
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(probes[i - 1], probes[rng.next() % i]);
+	for (std::size_t i = 0; i < n; ++i)
+		entries.push_back(ft::make_pair(probes[i], probes[i]));
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(probes[i - 1], probes[rng.next() % i]);
+
+	bench::header("shuffled int keys, loaded in one batch", n);
+	run<ft_flat>("ft::flat_map", entries, probes);
+	run<ft_btree>("ft::btree_map", entries, probes);
+	run<ft_map>("ft::map", entries, probes);
+	run<std_map>("std::map", entries, probes);
+	return 0;
+}
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+
+// In-place set operations between a big map and maps of growing size
+// unite() and subtract() relink nodes in O(m log(n/m + 1)), element by element is O(m log n)
+
+typedef ft::map<int, int>  ft_map;
+typedef std::map<int, int> std_map;
+typedef std::vector<int>   keys_t;
+
+template <typename Map>
+void fill(Map& m, keys_t const& keys)
+{
+	for (keys_t::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		m.insert(typename Map::value_type(*it, *it));
+}
+
+// Only the operation itself is timed, the maps are built beforehand
+template <typename Map>
+double time_insert_all(keys_t const& big, keys_t const& small)
+{
+	Map m, source;
+
+	fill(m, big);
+	fill(source, small);
+	double start = bench::now_ms();
+	m.insert(source.begin(), source.end());
+	source.clear();
+	double ms = bench::now_ms() - start;
+	bench::keep(m.size());
+	return ms;
+}
+
+double time_unite(keys_t const& big, keys_t const& small, std::size_t parallel_cutoff)
+{
+	ft_map m, source;
+
+	fill(m, big);
+	fill(source, small);
+	double start = bench::now_ms();
+	m.unite(source, parallel_cutoff);
+	double ms = bench::now_ms() - start;
+	bench::keep(m.size());
+	return ms;
+}
+
+template <typename Map>
+double time_erase_all(keys_t const& big, keys_t const& small)
+{
+	Map m, source;
+
+	fill(m, big);
+	fill(source, small);
+	double start = bench::now_ms();
+	for (typename Map::iterator it = source.begin(); it != source.end(); ++it)
+		m.erase(it->first);
+	source.clear();
+	double ms = bench::now_ms() - start;
+	bench::keep(m.size());
+	return ms;
+}
+
+double time_subtract(keys_t const& big, keys_t const& small)
+{
+	ft_map m, source;
+
+	fill(m, big);
+	fill(source, small);
+	double start = bench::now_ms();
+	m.subtract(source);
+	double ms = bench::now_ms() - start;
+	bench::keep(m.size());
+	return ms;
+}
+
+// Every other key of the small map is already in the big one
+keys_t some_keys(std::size_t n, std::size_t m, bench::rng& rng)
+{
+	keys_t keys;
+
+	for (std::size_t i = 0; i < m; ++i)
+		keys.push_back(static_cast<int>(rng.next() % (n * 2)) | static_cast<int>(i & 1));
+	return keys;
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t n = bench::size_arg(argc, argv, 1000000);
+	keys_t      big;
+	bench::rng  rng;
+	char        label[64];
+
+	for (std::size_t i = 0; i < n; ++i)
+		big.push_back(static_cast<int>(i * 2));
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(big[i - 1], big[rng.next() % i]);
+
+	for (std::size_t m = 100; m <= n; m *= 10)
+	{
+		keys_t small = some_keys(n, m, rng);
+
+		std::sprintf(label, "union with m = %lu", static_cast<unsigned long>(m));
+		bench::header(label, n);
+		bench::row("std::map insert(first, last)", time_insert_all<std_map>(big, small), m);
+		bench::row("ft::map insert(first, last)", time_insert_all<ft_map>(big, small), m);
+		bench::row("ft::map unite", time_unite(big, small, 0), m);
+		bench::row("ft::map unite, parallel_cutoff 4096", time_unite(big, small, 4096), m);
+
+		std::sprintf(label, "difference with m = %lu", static_cast<unsigned long>(m));
+		bench::header(label, n);
+		bench::row("std::map erase(key) each", time_erase_all<std_map>(big, small), m);
+		bench::row("ft::map erase(key) each", time_erase_all<ft_map>(big, small), m);
+		bench::row("ft::map subtract", time_subtract(big, small), m);
+	}
+	return 0;
+}
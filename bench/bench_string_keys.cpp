@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+
+// ft::map with string keys, with and without the prefixes nodes keep for std::less, see key_prefix.hpp
+
+typedef std::vector<std::string> keys_t;
+
+// Same order as std::less and the same single call per node, but key_prefix knows nothing about it
+struct string_less
+{
+	bool operator()(std::string const& a, std::string const& b) const
+	{
+		return a < b;
+	}
+};
+
+namespace ft
+{
+template <>
+struct three_way_compare<string_less>
+{
+	static int compare(string_less const&, std::string const& a, std::string const& b)
+	{
+		return a.compare(b);
+	}
+};
+} // namespace ft
+
+// Long shared prefixes, keys only tell each other apart well past the first 8 bytes
+static std::string make_url(bench::rng& rng)
+{
+	static char const *hosts[]    = { "https://www.example.com/", "https://static.example.com/", "https://api.example.org/" };
+	static char const *sections[] = { "products/", "users/", "articles/", "images/thumbnails/" };
+	char               buf[128];
+
+	std::sprintf(buf, "%s%sv2/%06lu/%lu", hosts[rng.next() % 3], sections[rng.next() % 4],
+	             static_cast<unsigned long>(rng.next() % 100000), static_cast<unsigned long>(rng.next() % 1000000));
+	return buf;
+}
+
+// Random hex from the first byte on, the prefix decides nearly every comparison
+static std::string make_uuid(bench::rng& rng)
+{
+	unsigned long long hi = rng.next();
+	unsigned long long lo = rng.next();
+	char               buf[40];
+
+	std::sprintf(buf, "%08lx-%04lx-4%03lx-%04lx-%012lx", static_cast<unsigned long>(hi >> 32),
+	             static_cast<unsigned long>((hi >> 16) & 0xffff), static_cast<unsigned long>(hi & 0xfff),
+	             static_cast<unsigned long>(0x8000 | (lo >> 48 & 0x3fff)), static_cast<unsigned long>(lo & 0xffffffffffffULL));
+	return buf;
+}
+
+template <typename Map>
+double time_fill(Map& m, keys_t const& keys)
+{
+	double start = bench::now_ms();
+
+	for (keys_t::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		m.insert(typename Map::value_type(*it, 1));
+	return bench::now_ms() - start;
+}
+
+// Every probe is there, in an order unrelated to the insertion order
+template <typename Map>
+double time_find(Map const& m, keys_t const& probes)
+{
+	double      start = bench::now_ms();
+	std::size_t found = 0;
+
+	for (keys_t::const_iterator it = probes.begin(); it != probes.end(); ++it)
+		found += m.find(*it)->second;
+	bench::keep(found);
+	return bench::now_ms() - start;
+}
+
+// None of the probes are there
+template <typename Map>
+double time_lower_bound(Map const& m, keys_t const& probes)
+{
+	double      start = bench::now_ms();
+	std::size_t found = 0;
+
+	for (keys_t::const_iterator it = probes.begin(); it != probes.end(); ++it)
+		found += m.lower_bound(*it) != m.end();
+	bench::keep(found);
+	return bench::now_ms() - start;
+}
+
+template <typename Map>
+void run(char const *name, keys_t const& keys, keys_t const& probes, keys_t const& misses)
+{
+	char label[64];
+	Map  m;
+
+	std::sprintf(label, "%s insert", name);
+	bench::row(label, time_fill(m, keys), keys.size());
+	std::sprintf(label, "%s find", name);
+	bench::row(label, time_find(m, probes), probes.size());
+	std::sprintf(label, "%s lower_bound, missing", name);
+	bench::row(label, time_lower_bound(m, misses), misses.size());
+}
+
+static void shuffle(keys_t& keys, bench::rng& rng)
+{
+	for (std::size_t i = keys.size(); i > 1; --i)
+		std::swap(keys[i - 1], keys[rng.next() % i]);
+}
+
+static void run_keys(char const *title, std::string (*make)(bench::rng&), std::size_t n)
+{
+	bench::rng rng;
+	keys_t     keys;
+	keys_t     misses;
+
+	for (std::size_t i = 0; i < n; ++i)
+		keys.push_back(make(rng));
+	for (std::size_t i = 0; i < n; ++i)
+		misses.push_back(make(rng) + "~"); // Sorts after any key it would share everything else with
+	keys_t probes(keys);
+	shuffle(probes, rng);
+
+	bench::header(title, n);
+	run<std::map<std::string, int> >("std::map", keys, probes, misses);
+	run<ft::map<std::string, int, string_less> >("ft::map, three-way", keys, probes, misses);
+	run<ft::map<std::string, int> >("ft::map, prefixes", keys, probes, misses);
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t n = bench::size_arg(argc, argv, 1000000);
+
+	run_keys("URL-like keys", make_url, n);
+	run_keys("UUID-like keys", make_uuid, n);
+	return 0;
+}
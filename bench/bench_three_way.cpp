@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "map.hpp"
+#include "compact_map.hpp"
+
+// Comparator calls and lookup throughput with and without three_way_compare
+
+static std::size_t comparisons = 0;
+
+// Only a less than, so the trees fall back on two calls wherever they need to tell equal keys apart
+template <typename T>
+struct two_way_less
+{
+	bool operator()(T const& a, T const& b) const
+	{
+		++comparisons;
+		return a < b;
+	}
+};
+
+// Same order, plus the specialization below that answers in one call
+template <typename T>
+struct three_way_less : two_way_less<T>
+{
+};
+
+namespace ft
+{
+template <>
+struct three_way_compare<three_way_less<std::string> >
+{
+	static int compare(three_way_less<std::string> const&, std::string const& a, std::string const& b)
+	{
+		++comparisons;
+		return a.compare(b);
+	}
+};
+
+template <>
+struct three_way_compare<three_way_less<unsigned> >
+{
+	static int compare(three_way_less<unsigned> const&, unsigned a, unsigned b)
+	{
+		++comparisons;
+		return static_cast<int>(b < a) - static_cast<int>(a < b);
+	}
+};
+} // namespace ft
+
+// What the trees do without the trait, not counted so that it times like std::less
+template <typename T>
+struct plain_less
+{
+	bool operator()(T const& a, T const& b) const
+	{
+		return a < b;
+	}
+};
+
+// Paths that share a long prefix, so that every comparison reads well into the strings
+static std::string make_key(std::size_t i)
+{
+	char buf[64];
+
+	std::sprintf(buf, "/srv/data/shards/0000/objects/%010lu", static_cast<unsigned long>(i));
+	return buf;
+}
+
+template <typename Map, typename Keys>
+void fill(Map& m, Keys const& keys)
+{
+	for (typename Keys::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		m.insert(typename Map::value_type(*it, 1));
+}
+
+// Every probe is there, in an order unrelated to the insertion order
+template <typename Map, typename Keys>
+double time_find(Map const& m, Keys const& probes)
+{
+	double      start = bench::now_ms();
+	std::size_t found = 0;
+
+	for (typename Keys::const_iterator it = probes.begin(); it != probes.end(); ++it)
+		found += m.find(*it)->second;
+	bench::keep(found);
+	return bench::now_ms() - start;
+}
+
+template <typename Map, typename Keys>
+void count_calls(char const *name, Keys const& keys, Keys const& probes)
+{
+	Map m;
+
+	comparisons = 0;
+	fill(m, keys);
+	double inserts = double(comparisons) / keys.size();
+	comparisons = 0;
+	time_find(m, probes);
+	double finds = double(comparisons) / probes.size();
+	std::printf("%-44s %8.1f per insert %8.1f per find\n", name, inserts, finds);
+}
+
+template <typename Map, typename Keys>
+void run(char const *name, Keys const& keys, Keys const& probes)
+{
+	char label[64];
+	Map  m;
+
+	fill(m, keys);
+	std::sprintf(label, "%s find", name);
+	bench::row(label, time_find(m, probes), probes.size());
+}
+
+template <typename Keys>
+void shuffle(Keys& keys, bench::rng& rng)
+{
+	for (std::size_t i = keys.size(); i > 1; --i)
+		std::swap(keys[i - 1], keys[rng.next() % i]);
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t               n = bench::size_arg(argc, argv, 1000000);
+	std::vector<std::string>  strings;
+	std::vector<unsigned>     ints;
+	bench::rng                rng;
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		strings.push_back(make_key(i * 2));
+		ints.push_back(static_cast<unsigned>(i * 2));
+	}
+	shuffle(strings, rng);
+	shuffle(ints, rng);
+	std::vector<std::string> string_probes(strings);
+	std::vector<unsigned>    int_probes(ints);
+	shuffle(string_probes, rng);
+	shuffle(int_probes, rng);
+
+	bench::header("comparator calls, string keys", n);
+	count_calls<std::map<std::string, int, two_way_less<std::string> > >("std::map", strings, string_probes);
+	count_calls<ft::map<std::string, int, two_way_less<std::string> > >("ft::map, two-way", strings, string_probes);
+	count_calls<ft::map<std::string, int, three_way_less<std::string> > >("ft::map, three-way", strings, string_probes);
+	count_calls<ft::compact_map<std::string, int, two_way_less<std::string> > >("ft::compact_map, two-way", strings, string_probes);
+	count_calls<ft::compact_map<std::string, int, three_way_less<std::string> > >("ft::compact_map, three-way", strings, string_probes);
+
+	bench::header("string keys with a 30 character common prefix", n);
+	run<std::map<std::string, int> >("std::map", strings, string_probes);
+	run<ft::map<std::string, int, plain_less<std::string> > >("ft::map, two-way", strings, string_probes);
+	run<ft::map<std::string, int> >("ft::map, three-way", strings, string_probes);
+	run<ft::compact_map<std::string, int, plain_less<std::string> > >("ft::compact_map, two-way", strings, string_probes);
+	run<ft::compact_map<std::string, int> >("ft::compact_map, three-way", strings, string_probes);
+
+	bench::header("unsigned keys", n);
+	run<std::map<unsigned, int> >("std::map", ints, int_probes);
+	run<ft::map<unsigned, int, plain_less<unsigned> > >("ft::map, two-way", ints, int_probes);
+	run<ft::map<unsigned, int> >("ft::map, three-way", ints, int_probes);
+	run<ft::compact_map<unsigned, int, plain_less<unsigned> > >("ft::compact_map, two-way", ints, int_probes);
+	run<ft::compact_map<unsigned, int> >("ft::compact_map, three-way", ints, int_probes);
+	return 0;
+}
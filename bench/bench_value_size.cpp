@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "bench.hpp"
+#include "compact_map.hpp"
+
+// compact_map with values in the nodes or in an array of their own, across value sizes
+// Lookups that only need the key get faster as values grow, those that read the value pay a line for it
+
+template <std::size_t Size>
+struct blob
+{
+	unsigned char bytes[Size];
+
+	/*Constructor*/ blob(unsigned seed = 0)
+	{
+		std::memset(bytes, static_cast<int>(seed), Size);
+	}
+};
+
+typedef unsigned int          key_t_;
+typedef std::vector<key_t_>   keys_t;
+
+template <typename Map>
+void fill(Map& m, keys_t const& keys)
+{
+	for (keys_t::const_iterator it = keys.begin(); it != keys.end(); ++it)
+		m.insert(typename Map::value_type(*it, typename Map::mapped_type(*it)));
+}
+
+// Membership only, the values are never read
+template <typename Map>
+double time_count(Map const& m, keys_t const& probes)
+{
+	double      start = bench::now_ms();
+	std::size_t found = 0;
+
+	for (keys_t::const_iterator it = probes.begin(); it != probes.end(); ++it)
+		found += m.count(*it);
+	bench::keep(found);
+	return bench::now_ms() - start;
+}
+
+// Finding then reading the first byte of the value
+template <typename Map>
+double time_find(Map const& m, keys_t const& probes)
+{
+	double      start = bench::now_ms();
+	std::size_t sum   = 0;
+
+	for (keys_t::const_iterator it = probes.begin(); it != probes.end(); ++it)
+		sum += m.find(*it)->second.bytes[0];
+	bench::keep(sum);
+	return bench::now_ms() - start;
+}
+
+template <typename Map>
+double time_scan(Map const& m)
+{
+	double      start = bench::now_ms();
+	std::size_t sum   = 0;
+
+	for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+		sum += it->first;
+	bench::keep(sum);
+	return bench::now_ms() - start;
+}
+
+template <typename Map>
+void run(char const *name, keys_t const& keys, keys_t const& probes)
+{
+	char label[64];
+	Map  m;
+
+	fill(m, keys);
+	std::sprintf(label, "%s count", name);
+	bench::row(label, time_count(m, probes), probes.size());
+	std::sprintf(label, "%s find + read", name);
+	bench::row(label, time_find(m, probes), probes.size());
+	std::sprintf(label, "%s scan keys", name);
+	bench::row(label, time_scan(m), keys.size());
+}
+
+template <std::size_t Size>
+void run_size(keys_t const& keys, keys_t const& probes)
+{
+	typedef blob<Size>                                             value_t;
+	typedef std::allocator<std::pair<const key_t_, value_t> >      alloc_t;
+	char                                                           title[64];
+
+	std::sprintf(title, "%lu byte values", static_cast<unsigned long>(Size));
+	bench::header(title, keys.size());
+	run<ft::compact_map<key_t_, value_t, std::less<key_t_>, alloc_t, ft::inline_values> >("inline", keys, probes);
+	run<ft::compact_map<key_t_, value_t, std::less<key_t_>, alloc_t, ft::separate_values> >("separate", keys, probes);
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t n = bench::size_arg(argc, argv, 1000000);
+	keys_t      keys;
+	bench::rng  rng;
+
+	for (std::size_t i = 0; i < n; ++i)
+		keys.push_back(static_cast<key_t_>(i * 2));
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(keys[i - 1], keys[rng.next() % i]);
+	keys_t probes(keys);
+	for (std::size_t i = n; i > 1; --i)
+		std::swap(probes[i - 1], probes[rng.next() % i]);
+
+	run_size<8>(keys, probes);
+	run_size<32>(keys, probes);
+	run_size<64>(keys, probes);
+	run_size<128>(keys, probes);
+	run_size<256>(keys, probes);
+	return 0;
+}
@@ -0,0 +1,1226 @@
+#ifndef BTREE_MAP_HPP
+#define BTREE_MAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "iterator_traits.hpp"
+#include "reverse_iterator.hpp"
+#include "pair.hpp"
+#include "algorithm.hpp"
+#include "enable_if.hpp"
+#include "has_is_transparent.hpp"
+#include "node_pool.hpp"
+
+namespace ft
+{
+
+// Same interface as ft::map, but every node holds a sorted run of elements that
+// fills a few cache lines, so a lookup touches a handful of nodes instead of one
+// node per level of a binary tree, and a scan reads elements back to back
+// Unlike ft::map, inserting or erasing invalidates every iterator
+template <typename Key, typename Value, typename KeyCmpFn = std::less<Key>,
+          typename Alloc = std::allocator<std::pair<const Key, Value> > >
+class btree_map
+{
+  protected:
+	struct leaf_node;
+	struct inner_node;
+
+	template <typename MaybeConstPair>
+	class btree_iterator;
+
+  public:
+	typedef Key                                                        key_type;
+	typedef Value                                                   mapped_type;
+	typedef ft::pair<const Key, Value>                               value_type;
+	typedef std::size_t                                               size_type;
+	typedef std::ptrdiff_t                                      difference_type;
+	typedef Alloc                                                allocator_type;
+	typedef KeyCmpFn                                                key_compare;
+	typedef value_type&                                               reference;
+	typedef value_type const&                                   const_reference;
+#if __cplusplus >= 201103L
+	typedef typename std::allocator_traits<Alloc>::pointer              pointer;
+	typedef typename std::allocator_traits<Alloc>::const_pointer  const_pointer;
+#else
+	typedef typename Alloc::pointer                                     pointer;
+	typedef typename Alloc::const_pointer                         const_pointer;
+#endif
+	typedef btree_iterator<value_type>                                 iterator;
+	typedef btree_iterator<value_type const>                     const_iterator;
+	typedef ft::reverse_iterator<iterator>                     reverse_iterator;
+	typedef ft::reverse_iterator<const_iterator>         const_reverse_iterator;
+
+  protected:
+	typedef leaf_node *                                              node_ptr_t;
+	typedef inner_node *                                            inner_ptr_t;
+#if __cplusplus >= 201103L
+	typedef typename
+	std::allocator_traits<Alloc>::template rebind_alloc<leaf_node> leaf_alloc_t;
+	typedef typename
+	std::allocator_traits<Alloc>::template rebind_alloc<inner_node> inner_alloc_t;
+#else
+	typedef typename
+	Alloc::template rebind<leaf_node>::other                       leaf_alloc_t;
+	typedef typename
+	Alloc::template rebind<inner_node>::other                     inner_alloc_t;
+#endif
+	typedef node_pool<leaf_node, leaf_alloc_t>                      leaf_pool_t;
+	typedef node_pool<inner_node, inner_alloc_t>                   inner_pool_t;
+
+	// Result when KeyCmpFn is transparent, no overload otherwise
+	// Taking the key type K makes the check happen at the call instead of when the map is instantiated
+	template <typename K, typename Result>
+	struct if_transparent_ : enable_if<has_is_transparent<KeyCmpFn>::value, Result>
+	{
+	};
+
+	/* NODE GEOMETRY */
+
+	// The fan-out follows from the element size: as many elements as fit in
+	// node_bytes_, i.e. four cache lines, and at least 3 so that splits make sense
+	static size_type const node_bytes_ = 256;
+	static size_type const slots_      = node_bytes_ / sizeof(value_type) > 3 ? node_bytes_ / sizeof(value_type) : 3;
+	// Below this many elements, a node takes from or merges with a sibling after an erase
+	static size_type const min_count_  = slots_ / 2;
+
+	// Room for the elements of a node, which only exist between construct_() and destroy_()
+	union slot_storage
+	{
+		unsigned char bytes[slots_ * sizeof(value_type)];
+		long double   align_as_long_double_;
+		long long     align_as_long_long_;
+		void         *align_as_pointer_;
+	};
+
+	/* NESTED NODE CLASSES */
+
+	struct leaf_node
+	{
+		inner_node     *parent;
+		unsigned short  position; // Index of this node among its parent's children
+		unsigned short  count;
+		bool            leaf;
+		slot_storage    slots;
+
+		value_type       &value(size_type i)       { return reinterpret_cast<value_type *>(slots.bytes)[i]; }
+		value_type const &value(size_type i) const { return reinterpret_cast<value_type const *>(slots.bytes)[i]; }
+		Key const        &key(size_type i)   const { return value(i).first; }
+	};
+
+	// Child i holds what sorts before element i, child count what sorts after the last one
+	struct inner_node : leaf_node
+	{
+		leaf_node *children[slots_ + 1];
+	};
+
+	/* STATE */
+	node_ptr_t          root_;      // NULL when empty
+	node_ptr_t          leftmost_;  // Leaf holding the first element
+	node_ptr_t          rightmost_; // Leaf holding the last element, end() is one past it
+	size_type           size_;
+	leaf_pool_t         leaf_pool_;
+	inner_pool_t        inner_pool_;
+	key_compare         compare_func_;
+
+	/* NODE HELPERS */
+
+	static inner_ptr_t inner_(node_ptr_t node)
+	{
+		return static_cast<inner_ptr_t>(node);
+	}
+
+	static node_ptr_t child_(node_ptr_t node, size_type i)
+	{
+		return inner_(node)->children[i];
+	}
+
+	// The child also learns where it now lives
+	static void set_child_(inner_ptr_t node, size_type i, node_ptr_t child)
+	{
+		node->children[i] = child;
+		child->parent     = node;
+		child->position   = static_cast<unsigned short>(i);
+	}
+
+	node_ptr_t new_leaf_()
+	{
+		node_ptr_t node = new (leaf_pool_.allocate()) leaf_node;
+
+		node->parent   = NULL;
+		node->position = 0;
+		node->count    = 0;
+		node->leaf     = true;
+		return node;
+	}
+
+	inner_ptr_t new_inner_()
+	{
+		inner_ptr_t node = new (inner_pool_.allocate()) inner_node;
+
+		node->parent   = NULL;
+		node->position = 0;
+		node->count    = 0;
+		node->leaf     = false;
+		return node;
+	}
+
+	// Its elements must be gone already
+	void delete_node_(node_ptr_t node)
+	{
+		if (node->leaf)
+			leaf_pool_.deallocate(node);
+		else
+			inner_pool_.deallocate(inner_(node));
+	}
+
+	/* ELEMENT HELPERS */
+
+	void construct_(node_ptr_t node, size_type i, value_type const& val)
+	{
+		new (&node->value(i)) value_type(val);
+	}
+
+	void destroy_(node_ptr_t node, size_type i)
+	{
+		node->value(i).~value_type();
+	}
+
+	// Moves element si of src into the free slot di of dst
+	void relocate_(node_ptr_t dst, size_type di, node_ptr_t src, size_type si)
+	{
+		construct_(dst, di, src->value(si));
+		destroy_(src, si);
+	}
+
+	// Frees slot i, the elements and children after it move one step to the right
+	// The child right after slot i is left for the caller to fill in
+	void open_slot_(node_ptr_t node, size_type i)
+	{
+		for (size_type j = node->count; j > i; --j)
+			relocate_(node, j, node, j - 1);
+		if (!node->leaf)
+			for (size_type j = node->count + 1; j > i + 1; --j)
+				set_child_(inner_(node), j, child_(node, j - 1));
+		++node->count;
+	}
+
+	// Removes the free slot i along with the child right after it
+	void close_slot_(node_ptr_t node, size_type i)
+	{
+		for (size_type j = i; j + 1 < node->count; ++j)
+			relocate_(node, j, node, j + 1);
+		if (!node->leaf)
+			for (size_type j = i + 1; j < node->count; ++j)
+				set_child_(inner_(node), j, child_(node, j + 1));
+		--node->count;
+	}
+
+	/* SEARCH */
+
+	// Index of the first element of node not less than k
+	// They take any K the comparator accepts, which is only ever something else than Key when it is transparent
+	template <typename K>
+	size_type lower_bound_in_(node_ptr_t node, K const& k) const
+	{
+		size_type lo = 0;
+		size_type hi = node->count;
+
+		while (lo < hi)
+		{
+			size_type mid = (lo + hi) / 2;
+			if (compare_func_(node->key(mid), k))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	// Index of the first element of node greater than k
+	template <typename K>
+	size_type upper_bound_in_(node_ptr_t node, K const& k) const
+	{
+		size_type lo = 0;
+		size_type hi = node->count;
+
+		while (lo < hi)
+		{
+			size_type mid = (lo + hi) / 2;
+			if (compare_func_(k, node->key(mid)))
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+
+	iterator end_() const
+	{
+		return iterator(rightmost_, rightmost_ == NULL ? 0 : rightmost_->count);
+	}
+
+	template <typename K>
+	iterator find_(K const& k) const
+	{
+		node_ptr_t node = root_;
+
+		while (node != NULL)
+		{
+			size_type i = lower_bound_in_(node, k);
+			if (i < node->count && !compare_func_(k, node->key(i)))
+				return iterator(node, i);
+			if (node->leaf)
+				break;
+			node = child_(node, i);
+		}
+		return end_();
+	}
+
+	// Every node on the way down offers a candidate, the deepest one is the closest
+	template <typename K>
+	iterator lower_bound_(K const& k) const
+	{
+		node_ptr_t node = root_;
+		iterator   best = end_();
+
+		while (node != NULL)
+		{
+			size_type i = lower_bound_in_(node, k);
+			if (i < node->count)
+				best = iterator(node, i);
+			if (node->leaf)
+				break;
+			node = child_(node, i);
+		}
+		return best;
+	}
+
+	template <typename K>
+	iterator upper_bound_(K const& k) const
+	{
+		node_ptr_t node = root_;
+		iterator   best = end_();
+
+		while (node != NULL)
+		{
+			size_type i = upper_bound_in_(node, k);
+			if (i < node->count)
+				best = iterator(node, i);
+			if (node->leaf)
+				break;
+			node = child_(node, i);
+		}
+		return best;
+	}
+
+	/* INSERTION */
+
+	// Either the element already holding k, or the leaf slot k should go to
+	// Returns true in the second case, an empty tree gets its root leaf here
+	bool insert_position_(Key const& k, node_ptr_t *node, size_type *i)
+	{
+		if (root_ == NULL)
+			root_ = leftmost_ = rightmost_ = new_leaf_();
+
+		node_ptr_t current = root_;
+		for (;;)
+		{
+			size_type pos = lower_bound_in_(current, k);
+			*node = current;
+			*i    = pos;
+			if (pos < current->count && !compare_func_(k, current->key(pos)))
+				return false;
+			if (current->leaf)
+				return true;
+			current = child_(current, pos);
+		}
+	}
+
+	// Splits the full node around a median that moves up to the parent, splitting
+	// the parent first if it is full too. node and i follow the insertion point
+	void split_(node_ptr_t &node, size_type &i)
+	{
+		if (node->parent == NULL) // Grows the tree at the top
+		{
+			inner_ptr_t top = new_inner_();
+			set_child_(top, 0, node);
+			root_ = top;
+		}
+		else if (node->parent->count == slots_)
+		{
+			node_ptr_t parent = node->parent;
+			size_type  at     = node->position;
+			split_(parent, at);
+		}
+
+		inner_ptr_t parent  = node->parent;
+		size_type   at      = node->position;
+		// Appending only sends the last element up, so that sorted input leaves full nodes behind
+		size_type   median  = (i == slots_) ? slots_ - 1 : slots_ / 2;
+		node_ptr_t  sibling = node->leaf ? new_leaf_() : new_inner_();
+
+		for (size_type j = median + 1; j < node->count; ++j)
+			relocate_(sibling, j - median - 1, node, j);
+		if (!node->leaf)
+			for (size_type j = median + 1; j <= node->count; ++j)
+				set_child_(inner_(sibling), j - median - 1, child_(node, j));
+		sibling->count = static_cast<unsigned short>(node->count - median - 1);
+		open_slot_(parent, at);
+		relocate_(parent, at, node, median);
+		set_child_(parent, at + 1, sibling);
+		node->count = static_cast<unsigned short>(median);
+		if (node == rightmost_)
+			rightmost_ = sibling;
+		if (i > median)
+		{
+			node = sibling;
+			i   -= median + 1;
+		}
+	}
+
+	// Elements only ever go in at the leaves
+	iterator insert_at_(node_ptr_t node, size_type i, value_type const& val)
+	{
+		if (node->count == slots_)
+			split_(node, i);
+		open_slot_(node, i);
+		try
+		{
+			construct_(node, i, val);
+		}
+		catch (...)
+		{
+			close_slot_(node, i);
+			throw;
+		}
+		++size_;
+		return iterator(node, i);
+	}
+
+	// prev and next are neighbours, one of them at least sits in a leaf
+	iterator insert_between_(iterator prev, iterator next, value_type const& val)
+	{
+		if (next.node_->leaf)
+			return insert_at_(next.node_, next.position_, val);
+		return insert_at_(prev.node_, prev.position_ + 1, val);
+	}
+
+	/* REMOVAL */
+
+	// Moves the separator and everything in right into left, its left sibling, then frees right
+	void merge_(node_ptr_t left, node_ptr_t right)
+	{
+		inner_ptr_t parent = left->parent;
+		size_type   at     = left->position;
+		size_type   base   = left->count + 1;
+
+		relocate_(left, left->count, parent, at);
+		for (size_type j = 0; j < right->count; ++j)
+			relocate_(left, base + j, right, j);
+		if (!left->leaf)
+			for (size_type j = 0; j <= right->count; ++j)
+				set_child_(inner_(left), base + j, child_(right, j));
+		left->count = static_cast<unsigned short>(left->count + right->count + 1);
+		close_slot_(parent, at); // right goes away with the separator's slot
+		if (right == rightmost_)
+			rightmost_ = left;
+		delete_node_(right);
+	}
+
+	// The last element of left goes up in place of the separator, which comes down to the front of node
+	void take_from_left_(node_ptr_t node, node_ptr_t left)
+	{
+		inner_ptr_t parent = node->parent;
+		size_type   at     = node->position - 1;
+
+		for (size_type j = node->count; j > 0; --j)
+			relocate_(node, j, node, j - 1);
+		relocate_(node, 0, parent, at);
+		relocate_(parent, at, left, left->count - 1);
+		if (!node->leaf)
+		{
+			for (size_type j = node->count + 1; j > 0; --j)
+				set_child_(inner_(node), j, child_(node, j - 1));
+			set_child_(inner_(node), 0, child_(left, left->count));
+		}
+		++node->count;
+		--left->count;
+	}
+
+	// The first element of right goes up in place of the separator, which comes down to the back of node
+	void take_from_right_(node_ptr_t node, node_ptr_t right)
+	{
+		inner_ptr_t parent = node->parent;
+		size_type   at     = node->position;
+
+		relocate_(node, node->count, parent, at);
+		relocate_(parent, at, right, 0);
+		if (!node->leaf)
+			set_child_(inner_(node), node->count + 1, child_(right, 0));
+		for (size_type j = 0; j + 1 < right->count; ++j)
+			relocate_(right, j, right, j + 1);
+		if (!right->leaf)
+			for (size_type j = 0; j < right->count; ++j)
+				set_child_(inner_(right), j, child_(right, j + 1));
+		++node->count;
+		--right->count;
+	}
+
+	// Refills nodes that went below min_count_, merging upwards as long as it takes
+	void rebalance_after_erase_(node_ptr_t node)
+	{
+		while (node != root_ && node->count < min_count_)
+		{
+			inner_ptr_t parent = node->parent;
+			size_type   at     = node->position;
+			node_ptr_t  left   = at > 0 ? child_(parent, at - 1) : NULL;
+			node_ptr_t  right  = at < parent->count ? child_(parent, at + 1) : NULL;
+
+			if (left != NULL && left->count + node->count < slots_)
+				merge_(left, node);
+			else if (right != NULL && node->count + right->count < slots_)
+				merge_(node, right);
+			else // Too full to merge means there is one to spare
+			{
+				if (left != NULL)
+					take_from_left_(node, left);
+				else
+					take_from_right_(node, right);
+				break;
+			}
+			node = parent;
+		}
+		if (root_->count == 0) // The tree shrinks from the top
+		{
+			node_ptr_t old_root = root_;
+			if (root_->leaf)
+				root_ = leftmost_ = rightmost_ = NULL;
+			else
+			{
+				root_           = child_(root_, 0);
+				root_->parent   = NULL;
+				root_->position = 0;
+			}
+			delete_node_(old_root);
+		}
+	}
+
+	void erase_at_(node_ptr_t node, size_type i)
+	{
+		destroy_(node, i);
+		if (!node->leaf) // Only leaves give up slots: the predecessor, last of its leaf, fills the hole
+		{
+			node_ptr_t leaf = child_(node, i);
+			while (!leaf->leaf)
+				leaf = child_(leaf, leaf->count);
+			relocate_(node, i, leaf, leaf->count - 1);
+			node = leaf;
+			i    = leaf->count - 1;
+		}
+		close_slot_(node, i);
+		--size_;
+		rebalance_after_erase_(node);
+	}
+
+	/* WHOLE TREE */
+
+	void destroy_subtree_(node_ptr_t node)
+	{
+		for (size_type i = 0; i < node->count; ++i)
+			destroy_(node, i);
+		if (!node->leaf)
+			for (size_type i = 0; i <= node->count; ++i)
+				if (child_(node, i) != NULL) // Only in a half built clone
+					destroy_subtree_(child_(node, i));
+	}
+
+	node_ptr_t new_node_like_(node_ptr_t src)
+	{
+		if (src->leaf)
+			return new_leaf_();
+		return new_inner_();
+	}
+
+	// Same shape, same elements. Counts follow the elements and a child slot is
+	// NULL until its node exists, so that a throw leaves a tree clear() can take down
+	void clone_(node_ptr_t src, node_ptr_t node)
+	{
+		if (!src->leaf)
+			clone_child_(src, node, 0);
+		for (size_type i = 0; i < src->count; ++i)
+		{
+			construct_(node, i, src->value(i));
+			++node->count;
+			if (!src->leaf)
+				clone_child_(src, node, i + 1);
+		}
+	}
+
+	void clone_child_(node_ptr_t src, node_ptr_t node, size_type i)
+	{
+		inner_(node)->children[i] = NULL;
+		set_child_(inner_(node), i, new_node_like_(child_(src, i)));
+		clone_(child_(src, i), child_(node, i));
+	}
+
+	void copy_from_(btree_map const& other)
+	{
+		if (other.root_ == NULL)
+			return;
+		try
+		{
+			root_ = new_node_like_(other.root_);
+			clone_(other.root_, root_);
+		}
+		catch (...)
+		{
+			clear();
+			throw;
+		}
+		size_ = other.size_;
+		for (leftmost_ = root_; !leftmost_->leaf; leftmost_ = child_(leftmost_, 0))
+			;
+		for (rightmost_ = root_; !rightmost_->leaf; rightmost_ = child_(rightmost_, rightmost_->count))
+			;
+	}
+
+  public:
+	/*Constructor*/ btree_map(Alloc alloc = Alloc()) :
+		root_(NULL),
+		leftmost_(NULL),
+		rightmost_(NULL),
+		size_(0),
+		leaf_pool_(leaf_alloc_t(alloc)),
+		inner_pool_(inner_alloc_t(alloc))
+	{ }
+
+	// Linear time when [first, last) is sorted, every element lands right before end()
+	template <typename InputIt>
+	/*Range Constructor*/ btree_map(InputIt first, InputIt last, KeyCmpFn const& comp = KeyCmpFn(), Alloc alloc = Alloc()) :
+		root_(NULL),
+		leftmost_(NULL),
+		rightmost_(NULL),
+		size_(0),
+		leaf_pool_(leaf_alloc_t(alloc)),
+		inner_pool_(inner_alloc_t(alloc)),
+		compare_func_(comp)
+	{
+		insert(first, last);
+	}
+
+	/*Copy Constructor*/ btree_map(btree_map const& other) :
+		root_(NULL),
+		leftmost_(NULL),
+		rightmost_(NULL),
+		size_(0),
+		leaf_pool_(other.leaf_pool_.get_allocator()),
+		inner_pool_(other.inner_pool_.get_allocator()),
+		compare_func_(other.compare_func_)
+	{
+		copy_from_(other);
+	}
+
+#if __cplusplus >= 201103L
+	// Takes other's nodes as they are, leaving it empty
+	/*Move Constructor*/ btree_map(btree_map&& other) :
+		root_(NULL),
+		leftmost_(NULL),
+		rightmost_(NULL),
+		size_(0),
+		leaf_pool_(other.leaf_pool_.get_allocator()),
+		inner_pool_(other.inner_pool_.get_allocator()),
+		compare_func_(other.compare_func_)
+	{
+		swap(other);
+	}
+#endif
+
+	/*Destructor*/ ~btree_map()
+	{
+		this->clear();
+	}
+
+	btree_map& operator=(btree_map const& rhs)
+	{
+		if (this != &rhs)
+		{
+			this->clear();
+			compare_func_ = rhs.compare_func_;
+			copy_from_(rhs);
+		}
+		return *this;
+	}
+
+#if __cplusplus >= 201103L
+	btree_map& operator=(btree_map&& rhs)
+	{
+		if (this != &rhs)
+		{
+			this->clear();
+			swap(rhs);
+		}
+		return *this;
+	}
+
+	template <typename... Args>
+	ft::pair<iterator, bool> emplace(Args&&... args)
+	{
+		return insert(value_type(std::forward<Args>(args)...));
+	}
+
+	// Unlike emplace, nothing is built when k is already there
+	template <typename... Args>
+	ft::pair<iterator, bool> try_emplace(Key const& k, Args&&... args)
+	{
+		node_ptr_t node;
+		size_type  i;
+
+		if (!insert_position_(k, &node, &i))
+			return ft::make_pair(iterator(node, i), false);
+		return ft::make_pair(insert_at_(node, i, value_type(k, Value(std::forward<Args>(args)...))), true);
+	}
+
+	template <typename M>
+	ft::pair<iterator, bool> insert_or_assign(Key const& k, M&& obj)
+	{
+		node_ptr_t node;
+		size_type  i;
+
+		if (!insert_position_(k, &node, &i))
+		{
+			node->value(i).second = std::forward<M>(obj);
+			return ft::make_pair(iterator(node, i), false);
+		}
+		return ft::make_pair(insert_at_(node, i, value_type(k, std::forward<M>(obj))), true);
+	}
+#endif
+
+	mapped_type& operator[]( const Key& key )
+	{
+		// Using operator[] requires that the mapped type be default constructible
+		node_ptr_t node;
+		size_type  i;
+
+		if (insert_position_(key, &node, &i))
+			return insert_at_(node, i, value_type(key, mapped_type()))->second;
+		return node->value(i).second;
+	}
+
+	// MODIFIERS
+
+	// Every node goes back at once, they are not freed one by one
+	void clear()
+	{
+		if (root_ != NULL)
+			destroy_subtree_(root_);
+		leaf_pool_.release();
+		inner_pool_.release();
+		root_      = NULL;
+		leftmost_  = NULL;
+		rightmost_ = NULL;
+		size_      = 0;
+	}
+
+	// Preallocates nodes for n more elements, counting on nodes being at least half full
+	void reserve(size_type n)
+	{
+		size_type leaves = n / min_count_ + 1;
+
+		leaf_pool_.reserve(leaves);
+		inner_pool_.reserve(leaves / min_count_ + 1);
+	}
+
+	ft::pair<iterator, bool> insert(value_type const& val)
+	{
+		node_ptr_t node;
+		size_type  i;
+
+		if (!insert_position_(val.first, &node, &i))
+			return ft::make_pair(iterator(node, i), false);
+		return ft::make_pair(insert_at_(node, i, val), true);
+	}
+
+	// Amortized O(1) per element when [first, last) is sorted
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last)
+	{
+		for (; first != last; ++first)
+			insert(end(), value_type(first->first, first->second));
+	}
+
+	// Replaces the content with [first, last), linear time if it is sorted
+	// The first of equal keys wins
+	template <typename InputIt>
+	void assign_sorted(InputIt first, InputIt last)
+	{
+		this->clear();
+		insert(first, last);
+	}
+
+	// Amortized O(1) when val belongs right before or right after hint
+	iterator insert(iterator hint, value_type const& val)
+	{
+		Key const& k = val.first;
+
+		if (root_ == NULL)
+			return insert(val).first;
+		if (hint == end() || compare_func_(k, hint->first)) // Goes right before hint ?
+		{
+			if (hint == begin())
+				return insert_at_(leftmost_, 0, val);
+			iterator prev = hint;
+			--prev;
+			if (compare_func_(prev->first, k))
+				return insert_between_(prev, hint, val);
+		}
+		else if (compare_func_(hint->first, k)) // Goes right after hint ?
+		{
+			iterator next = hint;
+			++next;
+			if (next == end() || compare_func_(k, next->first))
+				return insert_between_(hint, next, val);
+		}
+		else // Already there
+			return hint;
+		return insert(val).first;
+	}
+
+	size_type erase(Key const& k)
+	{
+		iterator it = find_(k);
+
+		if (it == end())
+			return 0;
+		erase_at_(it.node_, it.position_);
+		return 1;
+	}
+
+	void erase( iterator it )
+	{
+		erase_at_(it.node_, it.position_);
+	}
+
+	// Erasing invalidates iterators, so the range is walked by key: once the first
+	// element is gone, the lower bound of its key is the next one
+	void erase( iterator first, iterator last )
+	{
+		if (first == begin() && last == end())
+			return clear();
+
+		size_type n = 0;
+		for (iterator it = first; it != last; ++it)
+			++n;
+		if (n == 0)
+			return;
+		Key const k = first->first;
+		while (n-- > 0)
+		{
+			iterator it = lower_bound_(k);
+			erase_at_(it.node_, it.position_);
+		}
+	}
+
+	void swap( btree_map& other )
+	{
+		std::swap(root_, other.root_);
+		std::swap(leftmost_, other.leftmost_);
+		std::swap(rightmost_, other.rightmost_);
+		std::swap(size_, other.size_);
+		leaf_pool_.swap(other.leaf_pool_);
+		inner_pool_.swap(other.inner_pool_);
+		std::swap(compare_func_, other.compare_func_);
+	}
+
+	/* CAPACITY */
+
+	bool empty() const
+	{
+		return size_ == 0;
+	}
+
+	size_type size() const
+	{
+		return size_;
+	}
+
+	// One element per leaf is as low as it gets
+	size_type max_size() const
+	{
+		return leaf_pool_.max_size();
+	}
+
+	/* LOOKUP */
+
+	size_type count( const Key& key ) const
+	{
+		if (find(key) == this->end())
+			return 0;
+		return 1;
+	}
+
+	iterator find( const Key& key )
+	{
+		return find_(key);
+	}
+
+	const_iterator find( const Key& key ) const
+	{
+		return find_(key);
+	}
+
+	ft::pair<iterator,iterator> equal_range( const Key& key )
+	{
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+	ft::pair<const_iterator,const_iterator> equal_range( const Key& key ) const
+	{
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+	/* Returns lower bound not less than key */
+	iterator lower_bound( const Key& key )
+	{
+		return lower_bound_(key);
+	}
+
+	/* Returns lower bound not less than key */
+	const_iterator lower_bound( const Key& key ) const
+	{
+		return lower_bound_(key);
+	}
+
+	/* Returns iterator to the first element greater than key */
+	iterator upper_bound( const Key& key )
+	{
+		return upper_bound_(key);
+	}
+
+	/* Returns iterator to the first element greater than key */
+	const_iterator upper_bound( const Key& key ) const
+	{
+		return upper_bound_(key);
+	}
+
+	/* Heterogeneous lookup, only there if KeyCmpFn has an is_transparent member type */
+
+	template <typename K>
+	typename if_transparent_<K, size_type>::type count( const K& key ) const
+	{
+		if (find_(key) == end_())
+			return 0;
+		return 1;
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type find( const K& key )
+	{
+		return find_(key);
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type find( const K& key ) const
+	{
+		return find_(key);
+	}
+
+	template <typename K>
+	typename if_transparent_<K, ft::pair<iterator,iterator> >::type equal_range( const K& key )
+	{
+		return ft::make_pair(lower_bound_(key), upper_bound_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, ft::pair<const_iterator,const_iterator> >::type equal_range( const K& key ) const
+	{
+		return ft::make_pair(const_iterator(lower_bound_(key)), const_iterator(upper_bound_(key)));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type lower_bound( const K& key )
+	{
+		return lower_bound_(key);
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type lower_bound( const K& key ) const
+	{
+		return lower_bound_(key);
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type upper_bound( const K& key )
+	{
+		return upper_bound_(key);
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type upper_bound( const K& key ) const
+	{
+		return upper_bound_(key);
+	}
+
+	/* OBSERVERS */
+
+	allocator_type get_allocator() const
+	{
+		return allocator_type(leaf_pool_.get_allocator()); // Implicit conversion
+	}
+
+	key_compare key_comp() const
+	{
+		return compare_func_;
+	}
+
+	/* NESTED ITERATOR CLASSES */
+
+  protected:
+	// An element is a node and a slot in it, end() is the slot past the last element
+	template <typename MaybeConstPair>
+	class btree_iterator
+	{
+	  public:
+		typedef MaybeConstPair                                       value_type;
+		typedef value_type&                                           reference;
+		typedef value_type*                                             pointer;
+		typedef bidirectional_iterator_tag                    iterator_category;
+		typedef std::ptrdiff_t                                  difference_type;
+	  protected:
+		typedef
+		btree_map<Key, Value, KeyCmpFn, Alloc>::node_ptr_t           node_ptr_t;
+
+		friend class btree_map; // So that it can get to the slot behind an iterator
+
+		/* STATE */
+		node_ptr_t             node_;
+		size_type              position_;
+
+	  public:
+
+		/* Default Constructor */ btree_iterator()
+			: node_(NULL), position_(0)
+		{ }
+
+		/* Constructor */ btree_iterator(node_ptr_t node, size_type position)
+			: node_(node), position_(position)
+		{ }
+
+		/* Copy Constructor */ btree_iterator(btree_iterator const &other)
+			: node_(other.node_), position_(other.position_)
+		{ }
+
+		btree_iterator &operator=(btree_iterator const &rhs)
+		{
+			node_     = rhs.node_;
+			position_ = rhs.position_;
+			return *this;
+		}
+
+		/* Conversion */ operator btree_map<Key, Value, KeyCmpFn, Alloc>::const_iterator() const
+		{
+			return btree_map<Key, Value, KeyCmpFn, Alloc>::const_iterator(node_, position_);
+		}
+
+		pointer operator->() const { return &(this->operator*()); }
+
+		reference operator*() const { return node_->value(position_); }
+
+		bool operator==(btree_iterator const &rhs) const { return node_ == rhs.node_ && position_ == rhs.position_; }
+
+		bool operator!=(btree_iterator const &rhs) const { return !(*this == rhs); }
+
+		btree_iterator &operator++()
+		{
+			if (!node_->leaf) // Next is the first element of the subtree on the right
+			{
+				node_ = child_(node_, position_ + 1);
+				while (!node_->leaf)
+					node_ = child_(node_, 0);
+				position_ = 0;
+			}
+			else if (++position_ == node_->count) // Next is in the first ancestor with more elements on the right
+			{
+				node_ptr_t node     = node_;
+				size_type  position = position_;
+				while (position == node->count && node->parent != NULL)
+				{
+					position = node->position;
+					node     = node->parent;
+				}
+				if (position < node->count)
+				{
+					node_     = node;
+					position_ = position;
+				}
+				// Otherwise that was the last element, and one past the end of its leaf is end()
+			}
+			return *this;
+		}
+
+		btree_iterator &operator--()
+		{
+			if (!node_->leaf) // Previous is the last element of the subtree on the left
+			{
+				node_ = child_(node_, position_);
+				while (!node_->leaf)
+					node_ = child_(node_, node_->count);
+				position_ = node_->count - 1;
+			}
+			else if (position_ > 0)
+				--position_;
+			else // Previous is in the first ancestor with more elements on the left
+			{
+				node_ptr_t node     = node_;
+				size_type  position = 0;
+				while (position == 0 && node->parent != NULL)
+				{
+					position = node->position;
+					node     = node->parent;
+				}
+				if (position > 0)
+				{
+					node_     = node;
+					position_ = position - 1;
+				}
+			}
+			return *this;
+		}
+
+		btree_iterator operator++(int)
+		{
+			btree_iterator tmp = *this;
+			operator++();
+			return tmp;
+		}
+
+		btree_iterator operator--(int)
+		{
+			btree_iterator tmp = *this;
+			operator--();
+			return tmp;
+		}
+	};
+
+  public:
+	iterator begin()
+	{
+		return iterator(leftmost_, 0);
+	}
+
+	iterator end()
+	{
+		return end_();
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(leftmost_, 0);
+	}
+
+	const_iterator end() const
+	{
+		return end_();
+	}
+
+	reverse_iterator rbegin()
+	{
+		return reverse_iterator(this->end());
+	}
+
+	reverse_iterator rend()
+	{
+		return reverse_iterator(this->begin());
+	}
+
+	const_reverse_iterator rbegin() const
+	{
+		return const_reverse_iterator(this->end());
+	}
+
+	const_reverse_iterator rend() const
+	{
+		return const_reverse_iterator(this->begin());
+	}
+
+	/* VALUE COMPARE */
+
+	/* This exists only for forwarding the key_comp function*/
+	class value_compare
+	{
+		friend class btree_map;
+
+		protected:
+		KeyCmpFn comp;
+		value_compare(KeyCmpFn c) : comp(c)
+		{ }
+
+		public:
+		typedef value_type  first_argument_type;
+		typedef value_type  second_argument_type;
+		typedef bool        result_type;
+
+		bool operator()(value_type const& x, value_type const& y) const { return comp(x.first, y.first); }
+	};
+
+	value_compare value_comp() const
+	{
+		return value_compare(compare_func_);
+	}
+}; // class btree_map
+
+template< class Key, class T, class Compare, class Allocator >
+bool	operator==( btree_map< Key, T, Compare, Allocator > const & x, btree_map< Key, T, Compare, Allocator> const & y )
+{
+	if ( x.size() != y.size() )
+		return false;
+	return ft::equal( x.begin(), x.end(), y.begin() );
+}
+
+template< class Key, class T, class Compare, class Allocator >
+bool	operator<( btree_map< Key, T, Compare, Allocator > const & x, btree_map< Key, T, Compare, Allocator> const & y )
+{
+	return ft::lexicographical_compare( x.begin(), x.end(), y.begin(), y.end() );
+}
+
+template< class Key, class T, class Compare, class Allocator >
+bool	operator!=( btree_map< Key, T, Compare, Allocator > const & x, btree_map< Key, T, Compare, Allocator> const & y )
+{
+	return !( x == y );
+}
+
+template< class Key, class T, class Compare, class Allocator >
+bool	operator>( btree_map< Key, T, Compare, Allocator > const & x, btree_map< Key, T, Compare, Allocator> const & y )
+{
+	return y < x;
+}
+
+template< class Key, class T, class Compare, class Allocator >
+bool	operator>=( btree_map< Key, T, Compare, Allocator > const & x, btree_map< Key, T, Compare, Allocator> const & y )
+{
+	return !( x < y );
+}
+
+template< class Key, class T, class Compare, class Allocator >
+bool	operator<=( btree_map< Key, T, Compare, Allocator > const & x, btree_map< Key, T, Compare, Allocator> const & y )
+{
+	return !( y < x );
+}
+
+} // namespace ft
+
+// specialized algorithms
+namespace std {
+template< class Key, class T, class Compare, class Allocator >
+void	swap( ft::btree_map< Key, T, Compare, Allocator > & x, ft::btree_map< Key, T, Compare, Allocator > & y )
+{
+	x.swap( y );
+	return ;
+}
+} // namespace std
+
+#endif /* BTREE_MAP_HPP */
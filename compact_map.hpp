@@ -0,0 +1,1085 @@
+#ifndef COMPACT_MAP_HPP
+#define COMPACT_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "iterator_traits.hpp"
+#include "reverse_iterator.hpp"
+#include "pair.hpp"
+#include "algorithm.hpp"
+#include "enable_if.hpp"
+#include "has_is_transparent.hpp"
+#include "three_way_compare.hpp"
+#include "compact_storage.hpp"
+
+namespace ft
+{
+
+// The same AA tree as ft::map with a smaller footprint, for maps of small elements
+// Nodes sit next to each other in one array and link to each other by 32-bit
+// index, the level is packed above the left child's index, and there is no
+// parent link: iterators carry the path from the root instead, like the
+// recursive ft::AA_tree does. A node is 8 bytes plus its element, against 32
+// for ft::map, and erasing moves the last node into the freed slot so the array
+// never has holes
+// Like btree_map, inserting or erasing invalidates every iterator
+// Storage is inline_values or separate_values, see compact_storage.hpp: the
+// second keeps values out of the nodes, for lookups over large values
+template <typename Key, typename Value, typename KeyCmpFn = std::less<Key>,
+          typename Alloc = std::allocator<std::pair<const Key, Value> >,
+          typename Storage = inline_values>
+class compact_map
+{
+  protected:
+	typedef compact_slots<Key, Value, Alloc, Storage>                   slots_t;
+	typedef typename slots_t::view_type                               view_type;
+
+	template <typename MaybeConstValue>
+	class compact_iterator;
+
+  public:
+	typedef Key                                                        key_type;
+	typedef Value                                                   mapped_type;
+	typedef ft::pair<const Key, Value>                               value_type;
+	typedef std::size_t                                               size_type;
+	typedef std::ptrdiff_t                                      difference_type;
+	typedef Alloc                                                allocator_type;
+	typedef KeyCmpFn                                                key_compare;
+	typedef typename slots_t::template element<Value>::reference      reference;
+	typedef typename
+	slots_t::template element<const Value>::reference           const_reference;
+#if __cplusplus >= 201103L
+	typedef typename std::allocator_traits<Alloc>::pointer              pointer;
+	typedef typename std::allocator_traits<Alloc>::const_pointer  const_pointer;
+#else
+	typedef typename Alloc::pointer                                     pointer;
+	typedef typename Alloc::const_pointer                         const_pointer;
+#endif
+	typedef compact_iterator<Value>                                    iterator;
+	typedef compact_iterator<const Value>                        const_iterator;
+	typedef ft::reverse_iterator<iterator>                     reverse_iterator;
+	typedef ft::reverse_iterator<const_iterator>         const_reverse_iterator;
+
+  protected:
+	typedef compact_links::index_t                                      index_t;
+	typedef std::pair<Key, Value>                                 stored_pair_t;
+
+	// Result when KeyCmpFn is transparent, no overload otherwise
+	// Taking the key type K makes the check happen at the call instead of when the map is instantiated
+	template <typename K, typename Result>
+	struct if_transparent_ : enable_if<has_is_transparent<KeyCmpFn>::value, Result>
+	{
+	};
+
+	// Two nodes per level at most on the way down, one of them red
+	static size_type const max_depth_  = 2 * compact_links::index_bits;
+
+	/* STATE */
+	slots_t             slots_;    // Index 0 is NIL: no children and level 0, just like ft::map's NIL
+	size_type           size_;     // Elements are in slots 1 to size_
+	index_t             root_;
+	key_compare         compare_func_;
+
+	/* NODE HELPERS */
+
+	compact_links& node_(index_t node) const
+	{
+		return slots_.links(node);
+	}
+
+	Key const& key_(index_t node) const
+	{
+		return slots_.key(node);
+	}
+
+	// Negative, zero or positive as a sorts before, with or after b, see three_way_compare.hpp
+	template <typename A, typename B>
+	int compare_(A const& a, B const& b) const
+	{
+		return three_way_compare<KeyCmpFn>::compare(compare_func_, a, b);
+	}
+
+	// A lone node at level 1
+	void construct_(index_t node, stored_pair_t const& pair)
+	{
+		slots_.construct(node, pair);
+		node_(node).left_level = index_t(1) << compact_links::index_bits;
+		node_(node).right      = 0;
+	}
+
+	// Room for one more element, doubling the array when it is full
+	void make_room_()
+	{
+		if (size_ == max_size())
+			throw std::length_error("compact_map::insert");
+		if (size_ + 1 < slots_.capacity())
+			return;
+		size_type slots = slots_.capacity() < 16 ? 16 : slots_.capacity() * 2;
+		slots_.reallocate(std::min(slots, size_type(compact_links::index_mask) + 1), size_);
+	}
+
+	// Makes now take old's place under parent, 0 standing for above the root
+	void relink_(index_t parent, index_t old, index_t now)
+	{
+		if (parent == 0)
+			root_ = now;
+		else if (node_(parent).left() == old)
+			node_(parent).set_left(now);
+		else
+			node_(parent).right = now;
+	}
+
+	/*TREE BALANCING*/
+
+	// Both return the new top of the subtree, NIL is left alone
+	index_t skew_(index_t top)
+	{
+		index_t left = node_(top).left();
+
+		if (top == 0 || node_(left).level() != node_(top).level()) // No red node to our left ?
+			return top;
+		node_(top).set_left(node_(left).right);
+		node_(left).right = top;
+		return left;
+	}
+
+	index_t split_(index_t top)
+	{
+		index_t right = node_(top).right;
+
+		if (top == 0 || node_(node_(right).right).level() != node_(top).level()) // No 2 red nodes on our right ?
+			return top;
+		node_(top).right = node_(right).left();
+		node_(right).set_left(top);
+		node_(right).set_level(node_(right).level() + 1);
+		return right;
+	}
+
+	void update_level_(index_t node)
+	{
+		unsigned ideal_level = 1 + std::min(node_(node_(node).left()).level(), node_(node_(node).right).level());
+
+		if (node_(node).level() > ideal_level)
+		{
+			node_(node).set_level(ideal_level);
+			if (node_(node_(node).right).level() > ideal_level) // node's right child red ?
+				node_(node_(node).right).set_level(ideal_level);
+		}
+	}
+
+	index_t fixup_after_delete_(index_t node)
+	{
+		node = skew_(node);
+		node_(node).right = skew_(node_(node).right);
+		if (node_(node).right != 0)
+			node_(node_(node).right).right = skew_(node_(node_(node).right).right);
+		node = split_(node);
+		node_(node).right = split_(node_(node).right);
+		return node;
+	}
+
+	// path holds node's ancestors, root first. A new node only upsets its ancestors
+	// through horizontal links, so we skew and split upward until a subtree sits
+	// below its parent's level
+	void rebalance_after_insert_(index_t const *path, size_type depth, index_t node)
+	{
+		while (depth > 0 && node_(node).level() == node_(path[depth - 1]).level())
+		{
+			index_t current = path[--depth];
+
+			node = split_(skew_(current));
+			relink_(depth == 0 ? 0 : path[depth - 1], current, node);
+		}
+	}
+
+	// Lowers levels on the way up, until a subtree comes out as high as it was
+	void rebalance_after_erase_(index_t const *path, size_type depth)
+	{
+		while (depth-- > 0)
+		{
+			index_t  current   = path[depth];
+			unsigned old_level = node_(current).level();
+
+			update_level_(current);
+			if (node_(current).level() == old_level)
+				return;
+			index_t top = fixup_after_delete_(current);
+			relink_(depth == 0 ? 0 : path[depth - 1], current, top);
+			if (node_(top).level() == old_level)
+				return;
+		}
+	}
+
+	/* SEARCH */
+
+	// They take any K the comparator accepts, which is only ever something else than Key when it is transparent
+	template <typename K>
+	iterator find_(K const& k) const
+	{
+		iterator it(slots_.view(), root_);
+		index_t  current = root_;
+
+		while (current != 0)
+		{
+			int order = compare_(k, key_(current));
+
+			it.path_[it.depth_++] = current;
+			if (order == 0)
+				return it;
+			current = order < 0 ? node_(current).left() : node_(current).right;
+		}
+		it.depth_ = 0;
+		return it;
+	}
+
+	// The path to the closest candidate so far is a prefix of the path walked down
+	template <typename K>
+	iterator lower_bound_(K const& k) const
+	{
+		iterator  it(slots_.view(), root_);
+		index_t   current = root_;
+		size_type best    = 0;
+
+		while (current != 0)
+		{
+			it.path_[it.depth_++] = current;
+			if (!compare_func_(key_(current), k))
+			{
+				best    = it.depth_;
+				current = node_(current).left();
+			}
+			else
+				current = node_(current).right;
+		}
+		it.depth_ = best;
+		return it;
+	}
+
+	template <typename K>
+	iterator upper_bound_(K const& k) const
+	{
+		iterator  it(slots_.view(), root_);
+		index_t   current = root_;
+		size_type best    = 0;
+
+		while (current != 0)
+		{
+			it.path_[it.depth_++] = current;
+			if (compare_func_(k, key_(current)))
+			{
+				best    = it.depth_;
+				current = node_(current).left();
+			}
+			else
+				current = node_(current).right;
+		}
+		it.depth_ = best;
+		return it;
+	}
+
+	iterator begin_() const
+	{
+		iterator it(slots_.view(), root_);
+
+		for (index_t current = root_; current != 0; current = node_(current).left())
+			it.push_(current);
+		return it;
+	}
+
+	// Nodes do not know their parent, so an iterator to one is found by key
+	iterator iterator_to_(index_t node) const
+	{
+		return find_(key_(node));
+	}
+
+	index_t parent_of_(index_t node) const
+	{
+		index_t parent  = 0;
+		index_t current = root_;
+
+		while (current != node)
+		{
+			parent  = current;
+			current = compare_func_(key_(node), key_(current)) ? node_(current).left() : node_(current).right;
+		}
+		return parent;
+	}
+
+	/* INSERTION */
+
+	// Either it ends up on the element holding k, or on the path down to where
+	// k should go, as_left telling on which side of the last node
+	// Returns true in the second case
+	bool insert_position_(Key const& k, iterator *it, bool *as_left) const
+	{
+		index_t current = root_;
+
+		while (current != 0)
+		{
+			int order = compare_(k, key_(current));
+
+			it->path_[it->depth_++] = current;
+			if (order == 0)
+				return false;
+			*as_left = order < 0;
+			current  = *as_left ? node_(current).left() : node_(current).right;
+		}
+		return true;
+	}
+
+	// New elements take the slot right after the last one, returns that index
+	index_t insert_at_(index_t const *path, size_type depth, bool as_left, stored_pair_t const& pair)
+	{
+		make_room_();
+
+		index_t node = static_cast<index_t>(size_ + 1);
+		construct_(node, pair);
+		++size_;
+		if (depth == 0)
+			root_ = node;
+		else
+		{
+			if (as_left)
+				node_(path[depth - 1]).set_left(node);
+			else
+				node_(path[depth - 1]).right = node;
+			rebalance_after_insert_(path, depth, node);
+		}
+		return node;
+	}
+
+	// prev and next are neighbours, end() standing in for a missing one
+	// Either next has no left child or prev has no right child
+	iterator insert_between_(iterator const& prev, iterator const& next, value_type const& val)
+	{
+		index_t node;
+
+		if (next.depth_ != 0 && node_(next.node()).left() == 0)
+			node = insert_at_(next.path_, next.depth_, true, stored_pair_t(val.first, val.second));
+		else
+			node = insert_at_(prev.path_, prev.depth_, false, stored_pair_t(val.first, val.second));
+		return iterator_to_(node);
+	}
+
+	/* REMOVAL */
+
+	// The last element moves into the freed slot, its parent is found by key
+	void release_slot_(index_t node)
+	{
+		index_t last = static_cast<index_t>(size_);
+
+		slots_.destroy(node);
+		if (node != last)
+		{
+			index_t parent = parent_of_(last);
+			slots_.construct(node, slots_, last);
+			node_(node).left_level = node_(last).left_level;
+			node_(node).right      = node_(last).right;
+			relink_(parent, last, node);
+			slots_.destroy(last);
+		}
+		--size_;
+	}
+
+	// path leads to the element to erase, there is room in it to go further down
+	// An internal node has its successor take its place, so the link that goes
+	// away is always at level 1 and the rebalancing starts from there
+	void erase_at_(index_t *path, size_type depth)
+	{
+		size_type at   = depth - 1;
+		index_t   node = path[at];
+		index_t   replacement;
+
+		if (node_(node).left() != 0)
+		{
+			index_t succ = node_(node).right;
+			path[depth++] = succ;
+			while (node_(succ).left() != 0)
+			{
+				succ = node_(succ).left();
+				path[depth++] = succ;
+			}
+			replacement = node_(succ).right; // NIL or a red node on the same level
+			relink_(path[depth - 2], succ, replacement);
+			node_(succ).left_level = node_(node).left_level; // Same children, same level
+			node_(succ).right      = node_(node).right;
+			relink_(at == 0 ? 0 : path[at - 1], node, succ);
+			path[at] = succ;
+		}
+		else
+		{
+			replacement = node_(node).right;
+			relink_(at == 0 ? 0 : path[at - 1], node, replacement);
+		}
+		--depth;
+		// A red node takes over at the same level, nothing else moves
+		if (replacement == 0)
+			rebalance_after_erase_(path, depth);
+		release_slot_(node);
+	}
+
+	/* WHOLE TREE */
+
+	// Indices do not depend on where the array is, so a copy is the array copied
+	// size_ counts the elements copied so far, so that a throw leaves a map clear() can take down
+	void copy_from_(compact_map const& other)
+	{
+		if (other.size_ == 0)
+			return;
+		reserve(other.size_);
+		for (size_type i = 1; i <= other.size_; ++i)
+		{
+			index_t node = static_cast<index_t>(i);
+			slots_.construct(node, other.slots_, node);
+			node_(node).left_level = other.node_(node).left_level;
+			node_(node).right      = other.node_(node).right;
+			++size_;
+		}
+		root_ = other.root_;
+	}
+
+  public:
+	/*Constructor*/ compact_map(Alloc alloc = Alloc()) :
+		slots_(alloc),
+		size_(0),
+		root_(0)
+	{ }
+
+	template <typename InputIt>
+	/*Range Constructor*/ compact_map(InputIt first, InputIt last, KeyCmpFn const& comp = KeyCmpFn(), Alloc alloc = Alloc()) :
+		slots_(alloc),
+		size_(0),
+		root_(0),
+		compare_func_(comp)
+	{
+		insert(first, last);
+	}
+
+	/*Copy Constructor*/ compact_map(compact_map const& other) :
+		slots_(other.get_allocator()),
+		size_(0),
+		root_(0),
+		compare_func_(other.compare_func_)
+	{
+		try
+		{
+			copy_from_(other);
+		}
+		catch (...)
+		{
+			this->clear();
+			throw;
+		}
+	}
+
+#if __cplusplus >= 201103L
+	// Takes other's array as it is, leaving it empty
+	/*Move Constructor*/ compact_map(compact_map&& other) :
+		slots_(other.get_allocator()),
+		size_(0),
+		root_(0),
+		compare_func_(other.compare_func_)
+	{
+		swap(other);
+	}
+#endif
+
+	// slots_ lets go of the arrays
+	/*Destructor*/ ~compact_map()
+	{
+		this->clear();
+	}
+
+	compact_map& operator=(compact_map const& rhs)
+	{
+		if (this != &rhs)
+		{
+			this->clear();
+			compare_func_ = rhs.compare_func_;
+			try
+			{
+				copy_from_(rhs);
+			}
+			catch (...)
+			{
+				this->clear();
+				throw;
+			}
+		}
+		return *this;
+	}
+
+#if __cplusplus >= 201103L
+	compact_map& operator=(compact_map&& rhs)
+	{
+		if (this != &rhs)
+		{
+			this->clear();
+			swap(rhs);
+		}
+		return *this;
+	}
+
+	template <typename... Args>
+	ft::pair<iterator, bool> emplace(Args&&... args)
+	{
+		return insert(value_type(std::forward<Args>(args)...));
+	}
+
+	// Unlike emplace, nothing is built when k is already there
+	template <typename... Args>
+	ft::pair<iterator, bool> try_emplace(Key const& k, Args&&... args)
+	{
+		iterator it(slots_.view(), root_);
+		bool     as_left = false;
+
+		if (!insert_position_(k, &it, &as_left))
+			return ft::make_pair(it, false);
+		index_t node = insert_at_(it.path_, it.depth_, as_left, stored_pair_t(k, Value(std::forward<Args>(args)...)));
+		return ft::make_pair(iterator_to_(node), true);
+	}
+
+	template <typename M>
+	ft::pair<iterator, bool> insert_or_assign(Key const& k, M&& obj)
+	{
+		iterator it(slots_.view(), root_);
+		bool     as_left = false;
+
+		if (!insert_position_(k, &it, &as_left))
+		{
+			it->second = std::forward<M>(obj);
+			return ft::make_pair(it, false);
+		}
+		index_t node = insert_at_(it.path_, it.depth_, as_left, stored_pair_t(k, std::forward<M>(obj)));
+		return ft::make_pair(iterator_to_(node), true);
+	}
+#endif
+
+	mapped_type& operator[]( const Key& key )
+	{
+		// Using operator[] requires that the mapped type be default constructible
+		iterator it(slots_.view(), root_);
+		bool     as_left = false;
+
+		if (insert_position_(key, &it, &as_left))
+			return slots_.mapped(insert_at_(it.path_, it.depth_, as_left, stored_pair_t(key, mapped_type())));
+		return it->second;
+	}
+
+	// MODIFIERS
+
+	// The array stays, for whatever comes next
+	void clear()
+	{
+		for (size_type i = 1; i <= size_; ++i)
+			slots_.destroy(static_cast<index_t>(i));
+		size_ = 0;
+		root_ = 0;
+	}
+
+	// Room for n elements in all without moving the array again
+	void reserve(size_type n)
+	{
+		if (n > max_size())
+			throw std::length_error("compact_map::reserve");
+		if (n + 1 > slots_.capacity())
+			slots_.reallocate(n + 1, size_);
+	}
+
+	ft::pair<iterator, bool> insert(value_type const& val)
+	{
+		iterator it(slots_.view(), root_);
+		bool     as_left = false;
+
+		if (!insert_position_(val.first, &it, &as_left))
+			return ft::make_pair(it, false);
+		index_t node = insert_at_(it.path_, it.depth_, as_left, stored_pair_t(val.first, val.second));
+		return ft::make_pair(iterator_to_(node), true);
+	}
+
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last)
+	{
+		for (; first != last; ++first)
+			insert(end(), value_type(first->first, first->second));
+	}
+
+	// Saves the search when val belongs right before or right after hint
+	// Finding the returned iterator still takes one
+	iterator insert(iterator hint, value_type const& val)
+	{
+		Key const& k = val.first;
+
+		if (root_ == 0)
+			return insert(val).first;
+		if (hint == end() || compare_func_(k, hint->first)) // Goes right before hint ?
+		{
+			iterator prev = hint;
+			--prev; // Stepping back from the first element gives end()
+			if (prev == end() || compare_func_(prev->first, k))
+				return insert_between_(prev, hint, val);
+		}
+		else if (compare_func_(hint->first, k)) // Goes right after hint ?
+		{
+			iterator next = hint;
+			++next;
+			if (next == end() || compare_func_(k, next->first))
+				return insert_between_(hint, next, val);
+		}
+		else // Already there
+			return hint;
+		return insert(val).first;
+	}
+
+	size_type erase(Key const& k)
+	{
+		iterator it = find_(k);
+
+		if (it == end())
+			return 0;
+		erase_at_(it.path_, it.depth_);
+		return 1;
+	}
+
+	void erase( iterator it )
+	{
+		erase_at_(it.path_, it.depth_);
+	}
+
+	// Erasing invalidates iterators, so the range is walked by key: once the first
+	// element is gone, the lower bound of its key is the next one
+	void erase( iterator first, iterator last )
+	{
+		if (first == begin() && last == end())
+			return clear();
+
+		size_type n = 0;
+		for (iterator it = first; it != last; ++it)
+			++n;
+		if (n == 0)
+			return;
+		Key const k = first->first;
+		while (n-- > 0)
+		{
+			iterator it = lower_bound_(k);
+			erase_at_(it.path_, it.depth_);
+		}
+	}
+
+	void swap( compact_map& other )
+	{
+		slots_.swap(other.slots_);
+		std::swap(size_, other.size_);
+		std::swap(root_, other.root_);
+		std::swap(compare_func_, other.compare_func_);
+	}
+
+	/* CAPACITY */
+
+	bool empty() const
+	{
+		return size_ == 0;
+	}
+
+	size_type size() const
+	{
+		return size_;
+	}
+
+	// What 27-bit indices can address, NIL taking index 0
+	size_type max_size() const
+	{
+		return std::min(size_type(compact_links::index_mask), size_type(slots_.max_size() - 1));
+	}
+
+	/* LOOKUP */
+
+	size_type count( const Key& key ) const
+	{
+		if (find(key) == this->end())
+			return 0;
+		return 1;
+	}
+
+	iterator find( const Key& key )
+	{
+		return find_(key);
+	}
+
+	const_iterator find( const Key& key ) const
+	{
+		return find_(key);
+	}
+
+	ft::pair<iterator,iterator> equal_range( const Key& key )
+	{
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+	ft::pair<const_iterator,const_iterator> equal_range( const Key& key ) const
+	{
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+	/* Returns lower bound not less than key */
+	iterator lower_bound( const Key& key )
+	{
+		return lower_bound_(key);
+	}
+
+	/* Returns lower bound not less than key */
+	const_iterator lower_bound( const Key& key ) const
+	{
+		return lower_bound_(key);
+	}
+
+	/* Returns iterator to the first element greater than key */
+	iterator upper_bound( const Key& key )
+	{
+		return upper_bound_(key);
+	}
+
+	/* Returns iterator to the first element greater than key */
+	const_iterator upper_bound( const Key& key ) const
+	{
+		return upper_bound_(key);
+	}
+
+	/* Heterogeneous lookup, only there if KeyCmpFn has an is_transparent member type */
+
+	template <typename K>
+	typename if_transparent_<K, size_type>::type count( const K& key ) const
+	{
+		if (find_(key) == end())
+			return 0;
+		return 1;
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type find( const K& key )
+	{
+		return find_(key);
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type find( const K& key ) const
+	{
+		return find_(key);
+	}
+
+	template <typename K>
+	typename if_transparent_<K, ft::pair<iterator,iterator> >::type equal_range( const K& key )
+	{
+		return ft::make_pair(lower_bound_(key), upper_bound_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, ft::pair<const_iterator,const_iterator> >::type equal_range( const K& key ) const
+	{
+		return ft::make_pair(const_iterator(lower_bound_(key)), const_iterator(upper_bound_(key)));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type lower_bound( const K& key )
+	{
+		return lower_bound_(key);
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type lower_bound( const K& key ) const
+	{
+		return lower_bound_(key);
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type upper_bound( const K& key )
+	{
+		return upper_bound_(key);
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type upper_bound( const K& key ) const
+	{
+		return upper_bound_(key);
+	}
+
+	/* OBSERVERS */
+
+	allocator_type get_allocator() const
+	{
+		return slots_.get_allocator();
+	}
+
+	key_compare key_comp() const
+	{
+		return compare_func_;
+	}
+
+	/* NESTED ITERATOR CLASSES */
+
+  protected:
+	// Without parent links, an iterator keeps the whole path from the root to its
+	// element, end() is the empty path
+	template <typename MaybeConstValue>
+	class compact_iterator
+	{
+	  protected:
+		typedef typename slots_t::template element<MaybeConstValue>  element_t;
+	  public:
+		typedef typename element_t::value_type                       value_type;
+		typedef typename element_t::reference                         reference;
+		typedef typename element_t::pointer                             pointer;
+		typedef bidirectional_iterator_tag                    iterator_category;
+		typedef std::ptrdiff_t                                  difference_type;
+	  protected:
+		friend class compact_map; // So that it can get to the path behind an iterator
+		template <typename>
+		friend class compact_iterator;
+
+		/* STATE */
+		view_type              view_;
+		index_t                root_;              // Where stepping back from end() starts
+		size_type              depth_;
+		index_t                path_[max_depth_];  // Only the first depth_ are meaningful
+
+		index_t node() const
+		{
+			return path_[depth_ - 1];
+		}
+
+		compact_links& links_(index_t node) const
+		{
+			return view_.links(node);
+		}
+
+		void push_(index_t node)
+		{
+			path_[depth_++] = node;
+		}
+
+		void copy_path_(compact_iterator const &other)
+		{
+			std::copy(other.path_, other.path_ + other.depth_, path_);
+		}
+
+	  public:
+
+		/* Default Constructor */ compact_iterator()
+			: view_(), root_(0), depth_(0)
+		{ }
+
+		/* Constructor */ compact_iterator(view_type view, index_t root)
+			: view_(view), root_(root), depth_(0)
+		{ }
+
+		/* Copy Constructor */ compact_iterator(compact_iterator const &other)
+			: view_(other.view_), root_(other.root_), depth_(other.depth_)
+		{
+			copy_path_(other);
+		}
+
+		compact_iterator &operator=(compact_iterator const &rhs)
+		{
+			view_  = rhs.view_;
+			root_  = rhs.root_;
+			depth_ = rhs.depth_;
+			copy_path_(rhs);
+			return *this;
+		}
+
+		/* Conversion */ operator typename compact_map::const_iterator() const
+		{
+			typename compact_map::const_iterator it(view_, root_);
+
+			it.depth_ = depth_;
+			std::copy(path_, path_ + depth_, it.path_);
+			return it;
+		}
+
+		pointer operator->() const { return element_t::address(view_, node()); }
+
+		reference operator*() const { return element_t::at(view_, node()); }
+
+		bool operator==(compact_iterator const &rhs) const
+		{
+			return depth_ == rhs.depth_ && (depth_ == 0 || node() == rhs.node());
+		}
+
+		bool operator!=(compact_iterator const &rhs) const { return !(*this == rhs); }
+
+		compact_iterator &operator++()
+		{
+			index_t current = node();
+
+			if (links_(current).right != 0) // Next is the leftmost of the right subtree
+			{
+				push_(links_(current).right);
+				while (links_(node()).left() != 0)
+					push_(links_(node()).left());
+			}
+			else // Next is the first ancestor we reached from its left, end() if there is none
+			{
+				do
+					current = path_[--depth_];
+				while (depth_ > 0 && links_(node()).right == current);
+			}
+			return *this;
+		}
+
+		compact_iterator &operator--()
+		{
+			if (depth_ == 0 || links_(node()).left() != 0) // Previous is the rightmost of the left subtree
+			{
+				push_(depth_ == 0 ? root_ : links_(node()).left());
+				while (links_(node()).right != 0)
+					push_(links_(node()).right);
+			}
+			else // Previous is the first ancestor we reached from its right
+			{
+				index_t current;
+				do
+					current = path_[--depth_];
+				while (depth_ > 0 && links_(node()).left() == current);
+			}
+			return *this;
+		}
+
+		compact_iterator operator++(int)
+		{
+			compact_iterator tmp = *this;
+			operator++();
+			return tmp;
+		}
+
+		compact_iterator operator--(int)
+		{
+			compact_iterator tmp = *this;
+			operator--();
+			return tmp;
+		}
+	};
+
+  public:
+	iterator begin()
+	{
+		return begin_();
+	}
+
+	iterator end()
+	{
+		return iterator(slots_.view(), root_);
+	}
+
+	const_iterator begin() const
+	{
+		return begin_();
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(slots_.view(), root_);
+	}
+
+	reverse_iterator rbegin()
+	{
+		return reverse_iterator(this->end());
+	}
+
+	reverse_iterator rend()
+	{
+		return reverse_iterator(this->begin());
+	}
+
+	const_reverse_iterator rbegin() const
+	{
+		return const_reverse_iterator(this->end());
+	}
+
+	const_reverse_iterator rend() const
+	{
+		return const_reverse_iterator(this->begin());
+	}
+
+	/* VALUE COMPARE */
+
+	/* This exists only for forwarding the key_comp function*/
+	class value_compare
+	{
+		friend class compact_map;
+
+		protected:
+		KeyCmpFn comp;
+		value_compare(KeyCmpFn c) : comp(c)
+		{ }
+
+		public:
+		typedef value_type  first_argument_type;
+		typedef value_type  second_argument_type;
+		typedef bool        result_type;
+
+		bool operator()(value_type const& x, value_type const& y) const { return comp(x.first, y.first); }
+	};
+
+	value_compare value_comp() const
+	{
+		return value_compare(compare_func_);
+	}
+}; // class compact_map
+
+template< class Key, class T, class Compare, class Allocator, class Storage >
+bool	operator==( compact_map< Key, T, Compare, Allocator, Storage > const & x, compact_map< Key, T, Compare, Allocator, Storage > const & y )
+{
+	if ( x.size() != y.size() )
+		return false;
+	return ft::equal( x.begin(), x.end(), y.begin() );
+}
+
+template< class Key, class T, class Compare, class Allocator, class Storage >
+bool	operator<( compact_map< Key, T, Compare, Allocator, Storage > const & x, compact_map< Key, T, Compare, Allocator, Storage > const & y )
+{
+	return ft::lexicographical_compare( x.begin(), x.end(), y.begin(), y.end() );
+}
+
+template< class Key, class T, class Compare, class Allocator, class Storage >
+bool	operator!=( compact_map< Key, T, Compare, Allocator, Storage > const & x, compact_map< Key, T, Compare, Allocator, Storage > const & y )
+{
+	return !( x == y );
+}
+
+template< class Key, class T, class Compare, class Allocator, class Storage >
+bool	operator>( compact_map< Key, T, Compare, Allocator, Storage > const & x, compact_map< Key, T, Compare, Allocator, Storage > const & y )
+{
+	return y < x;
+}
+
+template< class Key, class T, class Compare, class Allocator, class Storage >
+bool	operator>=( compact_map< Key, T, Compare, Allocator, Storage > const & x, compact_map< Key, T, Compare, Allocator, Storage > const & y )
+{
+	return !( x < y );
+}
+
+template< class Key, class T, class Compare, class Allocator, class Storage >
+bool	operator<=( compact_map< Key, T, Compare, Allocator, Storage > const & x, compact_map< Key, T, Compare, Allocator, Storage > const & y )
+{
+	return !( y < x );
+}
+
+} // namespace ft
+
+// specialized algorithms
+namespace std {
+template< class Key, class T, class Compare, class Allocator, class Storage >
+void	swap( ft::compact_map< Key, T, Compare, Allocator, Storage > & x, ft::compact_map< Key, T, Compare, Allocator, Storage > & y )
+{
+	x.swap( y );
+	return ;
+}
+} // namespace std
+
+#endif /* COMPACT_MAP_HPP */
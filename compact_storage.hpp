@@ -0,0 +1,498 @@
+#ifndef COMPACT_STORAGE_HPP
+#define COMPACT_STORAGE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#if __cplusplus >= 201103L
+# include <type_traits>
+#endif
+
+#include "pair.hpp"
+
+namespace ft
+{
+
+// Policies for the last template parameter of ft::compact_map, telling where values live
+
+// The default, every node holds its whole element right after its links
+struct inline_values
+{
+};
+
+// Nodes hold their key and links only, values sit in an array of their own at
+// the node's index, so a lookup reads nothing but keys and links
+// Reaching a value takes one more cache line, and iterators hand out pairs of
+// references instead of references to pairs, like flat_map's
+struct separate_values
+{
+};
+
+/* LINKS */
+
+// How the nodes of a compact_map point at each other, by index, 0 being NIL
+// The low index_bits of a link are an index, which caps a map at 2^27 - 1 elements
+// Levels never go past log2 of the size, so the 5 bits left above are plenty
+struct compact_links
+{
+	typedef unsigned int index_t; // 32 bits wherever we build
+
+	static unsigned const index_bits = 27;
+	static index_t const  index_mask = (index_t(1) << index_bits) - 1;
+
+	index_t left_level; // Index of the left child, the level above it
+	index_t right;
+
+	index_t  left() const  { return left_level & index_mask; }
+	unsigned level() const { return left_level >> index_bits; }
+
+	void set_left(index_t node)    { left_level = (left_level & ~index_mask) | node; }
+	void set_level(unsigned level) { left_level = (left_level & index_mask) | (index_t(level) << index_bits); }
+};
+
+/* SLOTS */
+
+// The arrays behind a compact_map: slot 0 holds NIL's links and nothing else,
+// elements are in slots 1 to the map's size and only exist between construct()
+// and destroy(). Links are the map's business, elements are the slots'
+// Both layouts have the same interface, view_type being what iterators keep to
+// follow links and reach elements, and element<MaybeConstValue> what they give
+template <typename Key, typename Value, typename Alloc, typename Storage>
+class compact_slots;
+
+template <typename Key, typename Value, typename Alloc>
+class compact_slots<Key, Value, Alloc, inline_values>
+{
+  public:
+	typedef compact_links::index_t                                      index_t;
+	typedef std::size_t                                               size_type;
+	typedef std::pair<Key, Value>                                 stored_pair_t;
+	typedef ft::pair<const Key, Value>                               value_type;
+
+	struct node : compact_links
+	{
+		value_type pair; // What iterators hand out, as is
+	};
+
+	struct view_type
+	{
+		node *nodes;
+
+		compact_links& links(index_t i) const { return nodes[i]; }
+	};
+
+	// The element itself, read only when MaybeConstValue is const
+	template <typename MaybeConstValue>
+	struct referred
+	{
+		typedef value_type type;
+	};
+
+	template <typename MaybeConstValue>
+	struct referred<MaybeConstValue const>
+	{
+		typedef value_type const type;
+	};
+
+	template <typename MaybeConstValue>
+	struct element
+	{
+		typedef ft::pair<const Key, Value>                           value_type;
+		typedef typename referred<MaybeConstValue>::type&             reference;
+		typedef typename referred<MaybeConstValue>::type*               pointer;
+
+		static reference at(view_type const& view, index_t i)
+		{
+			return view.nodes[i].pair;
+		}
+
+		static pointer address(view_type const& view, index_t i)
+		{
+			return &at(view, i);
+		}
+	};
+
+  protected:
+#if __cplusplus >= 201103L
+	typedef typename
+	std::allocator_traits<Alloc>::template rebind_alloc<node>      node_alloc_t;
+#else
+	typedef typename
+	Alloc::template rebind<node>::other                            node_alloc_t;
+#endif
+
+	/* STATE */
+	node_alloc_t        alloc_;
+	node               *nodes_;    // NULL until the first reallocate()
+	size_type           capacity_; // Slots, NIL's included
+
+  private:
+	/*Copy Constructor*/ compact_slots(compact_slots const&);
+	compact_slots& operator=(compact_slots const&);
+
+  public:
+	/*Constructor*/ explicit compact_slots(Alloc const& alloc) :
+		alloc_(alloc),
+		nodes_(NULL),
+		capacity_(0)
+	{ }
+
+	// The elements must be gone already
+	/*Destructor*/ ~compact_slots()
+	{
+		if (nodes_ != NULL)
+			alloc_.deallocate(nodes_, capacity_);
+	}
+
+	view_type view() const
+	{
+		view_type view;
+
+		view.nodes = nodes_;
+		return view;
+	}
+
+	compact_links& links(index_t i) const { return nodes_[i]; }
+	Key const&     key(index_t i) const   { return nodes_[i].pair.first; }
+	Value&         mapped(index_t i) const { return nodes_[i].pair.second; }
+
+	size_type capacity() const { return capacity_; }
+	size_type max_size() const { return alloc_.max_size(); }
+	Alloc     get_allocator() const { return Alloc(alloc_); }
+
+	void construct(index_t i, stored_pair_t const& pair)
+	{
+		new (&nodes_[i].pair) value_type(pair.first, pair.second);
+	}
+
+	// Copies element j of from into the free slot i, from may be this
+	void construct(index_t i, compact_slots const& from, index_t j)
+	{
+		new (&nodes_[i].pair) value_type(from.nodes_[j].pair);
+	}
+
+	void destroy(index_t i)
+	{
+		nodes_[i].pair.~value_type();
+	}
+
+  protected:
+	// Builds a copy of from at to, or moves from into it when neither half can throw,
+	// the key included since from is destroyed right after
+	static void relocate_(value_type *to, value_type& from)
+	{
+#if __cplusplus >= 201103L
+		if (std::is_nothrow_move_constructible<Key>::value && std::is_nothrow_move_constructible<Value>::value)
+			new (to) value_type(std::move(const_cast<Key&>(from.first)), std::move(from.second));
+		else
+#endif
+			new (to) value_type(from);
+	}
+
+  public:
+	// Moves to an array of slots slots, the first size elements and their links come along
+	void reallocate(size_type slots, size_type size)
+	{
+		node     *fresh = alloc_.allocate(slots);
+		size_type moved = 1;
+
+		try
+		{
+			for (; moved <= size; ++moved)
+				relocate_(&fresh[moved].pair, nodes_[moved].pair);
+		}
+		catch (...)
+		{
+			while (--moved > 0)
+				fresh[moved].pair.~value_type();
+			alloc_.deallocate(fresh, slots);
+			throw;
+		}
+		fresh[0].left_level = 0;
+		fresh[0].right      = 0;
+		for (size_type i = 1; i <= size; ++i)
+		{
+			fresh[i].left_level = nodes_[i].left_level;
+			fresh[i].right      = nodes_[i].right;
+			destroy(static_cast<index_t>(i));
+		}
+		if (nodes_ != NULL)
+			alloc_.deallocate(nodes_, capacity_);
+		nodes_    = fresh;
+		capacity_ = slots;
+	}
+
+	void swap(compact_slots& other)
+	{
+		std::swap(alloc_, other.alloc_);
+		std::swap(nodes_, other.nodes_);
+		std::swap(capacity_, other.capacity_);
+	}
+};
+
+template <typename Key, typename Value, typename Alloc>
+class compact_slots<Key, Value, Alloc, separate_values>
+{
+  public:
+	typedef compact_links::index_t                                      index_t;
+	typedef std::size_t                                               size_type;
+	typedef std::pair<Key, Value>                                 stored_pair_t;
+
+	struct node : compact_links
+	{
+		Key key;
+	};
+
+	struct view_type
+	{
+		node  *nodes;
+		Value *values;
+
+		compact_links& links(index_t i) const { return nodes[i]; }
+	};
+
+	// Dereferencing makes a pair of references on the spot, -> has to keep one alive
+	template <typename MaybeConstValue>
+	struct element
+	{
+		typedef ft::pair<const Key, MaybeConstValue>                 value_type;
+
+		struct reference
+		{
+			Key const&       first;
+			MaybeConstValue& second;
+
+			/*Constructor*/ reference(Key const& k, MaybeConstValue& v) : first(k), second(v) { }
+
+			operator ft::pair<const Key, Value>() const
+			{
+				return ft::pair<const Key, Value>(first, second);
+			}
+
+			// What pairs do, for the comparisons between maps
+			bool operator==(reference const& rhs) const
+			{
+				return first == rhs.first && second == rhs.second;
+			}
+
+			bool operator!=(reference const& rhs) const
+			{
+				return !(*this == rhs);
+			}
+
+			bool operator<(reference const& rhs) const
+			{
+				return first < rhs.first || (!(rhs.first < first) && second < rhs.second);
+			}
+		};
+
+		class pointer
+		{
+			reference ref_;
+
+		  public:
+			explicit pointer(reference ref) : ref_(ref) { }
+			reference const *operator->() const { return &ref_; }
+		};
+
+		static reference at(view_type const& view, index_t i)
+		{
+			return reference(view.nodes[i].key, view.values[i]);
+		}
+
+		static pointer address(view_type const& view, index_t i)
+		{
+			return pointer(at(view, i));
+		}
+	};
+
+  protected:
+#if __cplusplus >= 201103L
+	typedef typename
+	std::allocator_traits<Alloc>::template rebind_alloc<node>      node_alloc_t;
+	typedef typename
+	std::allocator_traits<Alloc>::template rebind_alloc<Value>    value_alloc_t;
+#else
+	typedef typename
+	Alloc::template rebind<node>::other                            node_alloc_t;
+	typedef typename
+	Alloc::template rebind<Value>::other                          value_alloc_t;
+#endif
+
+	/* STATE */
+	node_alloc_t        alloc_;
+	value_alloc_t       value_alloc_;
+	node               *nodes_;    // NULL until the first reallocate()
+	Value              *values_;   // Same length, the value of node i is values_[i]
+	size_type           capacity_; // Slots in each, NIL's included
+
+	// Moves keys and values over to fresh arrays, or copies them when moving could throw
+	// Nothing is left built in fresh if that throws
+	template <typename T>
+	static void transfer_(T *fresh, T *old, size_type size)
+	{
+		size_type moved = 1;
+
+		try
+		{
+			for (; moved <= size; ++moved)
+#if __cplusplus >= 201103L
+				new (&fresh[moved]) T(std::move_if_noexcept(old[moved]));
+#else
+				new (&fresh[moved]) T(old[moved]);
+#endif
+		}
+		catch (...)
+		{
+			while (--moved > 0)
+				fresh[moved].~T();
+			throw;
+		}
+	}
+
+  private:
+	/*Copy Constructor*/ compact_slots(compact_slots const&);
+	compact_slots& operator=(compact_slots const&);
+
+  public:
+	/*Constructor*/ explicit compact_slots(Alloc const& alloc) :
+		alloc_(alloc),
+		value_alloc_(alloc),
+		nodes_(NULL),
+		values_(NULL),
+		capacity_(0)
+	{ }
+
+	// The elements must be gone already
+	/*Destructor*/ ~compact_slots()
+	{
+		if (nodes_ != NULL)
+		{
+			alloc_.deallocate(nodes_, capacity_);
+			value_alloc_.deallocate(values_, capacity_);
+		}
+	}
+
+	view_type view() const
+	{
+		view_type view;
+
+		view.nodes  = nodes_;
+		view.values = values_;
+		return view;
+	}
+
+	compact_links& links(index_t i) const { return nodes_[i]; }
+	Key const&     key(index_t i) const   { return nodes_[i].key; }
+	Value&         mapped(index_t i) const { return values_[i]; }
+
+	size_type capacity() const { return capacity_; }
+	size_type max_size() const { return std::min(alloc_.max_size(), value_alloc_.max_size()); }
+	Alloc     get_allocator() const { return Alloc(alloc_); }
+
+	void construct(index_t i, stored_pair_t const& pair)
+	{
+		new (&nodes_[i].key) Key(pair.first);
+		try
+		{
+			new (&values_[i]) Value(pair.second);
+		}
+		catch (...)
+		{
+			nodes_[i].key.~Key();
+			throw;
+		}
+	}
+
+	// Copies element j of from into the free slot i, from may be this
+	void construct(index_t i, compact_slots const& from, index_t j)
+	{
+		new (&nodes_[i].key) Key(from.nodes_[j].key);
+		try
+		{
+			new (&values_[i]) Value(from.values_[j]);
+		}
+		catch (...)
+		{
+			nodes_[i].key.~Key();
+			throw;
+		}
+	}
+
+	void destroy(index_t i)
+	{
+		nodes_[i].key.~Key();
+		values_[i].~Value();
+	}
+
+	// Moves to arrays of slots slots, the first size elements and their links come along
+	void reallocate(size_type slots, size_type size)
+	{
+		node  *fresh_nodes  = alloc_.allocate(slots);
+		Value *fresh_values = NULL;
+
+		try
+		{
+			fresh_values = value_alloc_.allocate(slots);
+			transfer_(fresh_values, values_, size);
+		}
+		catch (...)
+		{
+			if (fresh_values != NULL)
+				value_alloc_.deallocate(fresh_values, slots);
+			alloc_.deallocate(fresh_nodes, slots);
+			throw;
+		}
+		size_type moved = 1;
+		try
+		{
+			for (; moved <= size; ++moved)
+#if __cplusplus >= 201103L
+				new (&fresh_nodes[moved].key) Key(std::move_if_noexcept(nodes_[moved].key));
+#else
+				new (&fresh_nodes[moved].key) Key(nodes_[moved].key);
+#endif
+		}
+		catch (...)
+		{
+			while (--moved > 0)
+				fresh_nodes[moved].key.~Key();
+			for (size_type i = 1; i <= size; ++i)
+				fresh_values[i].~Value();
+			value_alloc_.deallocate(fresh_values, slots);
+			alloc_.deallocate(fresh_nodes, slots);
+			throw;
+		}
+		fresh_nodes[0].left_level = 0;
+		fresh_nodes[0].right      = 0;
+		for (size_type i = 1; i <= size; ++i)
+		{
+			fresh_nodes[i].left_level = nodes_[i].left_level;
+			fresh_nodes[i].right      = nodes_[i].right;
+			destroy(static_cast<index_t>(i));
+		}
+		if (nodes_ != NULL)
+		{
+			alloc_.deallocate(nodes_, capacity_);
+			value_alloc_.deallocate(values_, capacity_);
+		}
+		nodes_    = fresh_nodes;
+		values_   = fresh_values;
+		capacity_ = slots;
+	}
+
+	void swap(compact_slots& other)
+	{
+		std::swap(alloc_, other.alloc_);
+		std::swap(value_alloc_, other.value_alloc_);
+		std::swap(nodes_, other.nodes_);
+		std::swap(values_, other.values_);
+		std::swap(capacity_, other.capacity_);
+	}
+};
+
+} // namespace ft
+
+#endif /* COMPACT_STORAGE_HPP */
@@ -22,7 +22,7 @@ struct enable_if
 template <typename T>
 struct enable_if<true, T>
 {
-	T value;
+	typedef T type;
 };
 
 #endif /* ENABLE_IF_HPP */
@@ -0,0 +1,676 @@
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+#include "iterator_traits.hpp"
+#include "pair.hpp"
+#include "algorithm.hpp"
+#include "enable_if.hpp"
+#include "has_is_transparent.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+
+// Sorted keys and their values in two parallel ft::vectors, for tables that are
+// loaded once and then queried a lot: no per element allocation, and a lookup is a
+// binary search over keys packed next to each other
+// Inserting or erasing a single element is linear, insert_many() amortizes bulk loads
+// Like ft::vector, modifying the map invalidates every iterator
+template <typename Key, typename Value, typename KeyCmpFn = std::less<Key>,
+          typename Alloc = std::allocator<std::pair<const Key, Value> > >
+class flat_map
+{
+  protected:
+	template <typename MaybeConstValue>
+	class flat_iterator;
+
+  public:
+	// Keys and values live apart, so an element is only ever seen through references to both
+	// Not an ft::pair of references, C++98 does not collapse the references pair's members take
+	template <typename MaybeConstValue>
+	struct flat_reference
+	{
+		Key const&       first;
+		MaybeConstValue& second;
+
+		/*Constructor*/ flat_reference(Key const& k, MaybeConstValue& v) : first(k), second(v) { }
+
+		operator ft::pair<const Key, Value>() const
+		{
+			return ft::pair<const Key, Value>(first, second);
+		}
+	};
+
+  public:
+	typedef Key                                                        key_type;
+	typedef Value                                                   mapped_type;
+	typedef ft::pair<const Key, Value>                               value_type;
+	typedef std::size_t                                               size_type;
+	typedef std::ptrdiff_t                                      difference_type;
+	typedef Alloc                                                allocator_type;
+	typedef KeyCmpFn                                                key_compare;
+	typedef flat_reference<Value>                                     reference;
+	typedef flat_reference<const Value>                         const_reference;
+	typedef flat_iterator<Value>                                       iterator;
+	typedef flat_iterator<const Value>                           const_iterator;
+
+  protected:
+#if __cplusplus >= 201103L
+	typedef typename
+	std::allocator_traits<Alloc>::template rebind_alloc<Key>        key_alloc_t;
+	typedef typename
+	std::allocator_traits<Alloc>::template rebind_alloc<Value>    value_alloc_t;
+#else
+	typedef typename
+	Alloc::template rebind<Key>::other                              key_alloc_t;
+	typedef typename
+	Alloc::template rebind<Value>::other                          value_alloc_t;
+#endif
+	typedef ft::vector<Key, key_alloc_t>                                 keys_t;
+	typedef ft::vector<Value, value_alloc_t>                           values_t;
+	typedef ft::vector<size_type>                                     indices_t;
+
+	// Result when KeyCmpFn is transparent, no overload otherwise
+	// Taking the key type K makes the check happen at the call instead of when the map is instantiated
+	template <typename K, typename Result>
+	struct if_transparent_ : enable_if<has_is_transparent<KeyCmpFn>::value, Result>
+	{
+	};
+
+	// Orders positions in keys by the key they point to, ties by position
+	struct index_compare_
+	{
+		keys_t const&     keys;
+		key_compare const& comp;
+
+		index_compare_(keys_t const& k, key_compare const& c) : keys(k), comp(c) { }
+
+		bool operator()(size_type a, size_type b) const
+		{
+			if (comp(keys[a], keys[b]))
+				return true;
+			if (comp(keys[b], keys[a]))
+				return false;
+			return a < b;
+		}
+	};
+
+	/* STATE */
+	keys_t              keys_;   // Sorted and unique
+	values_t            values_; // values_[i] goes with keys_[i]
+	key_compare         compare_func_;
+
+	/* SEARCH */
+
+	// Index of the first key not less than k
+	// They take any K the comparator accepts, which is only ever something else than Key when it is transparent
+	template <typename K>
+	size_type lower_bound_index_(K const& k) const
+	{
+		size_type lo = 0;
+		size_type hi = keys_.size();
+
+		while (lo < hi)
+		{
+			size_type mid = lo + (hi - lo) / 2;
+			if (compare_func_(keys_[mid], k))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	// Index of the first key greater than k
+	template <typename K>
+	size_type upper_bound_index_(K const& k) const
+	{
+		size_type lo = 0;
+		size_type hi = keys_.size();
+
+		while (lo < hi)
+		{
+			size_type mid = lo + (hi - lo) / 2;
+			if (compare_func_(k, keys_[mid]))
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+
+	// size() when there is no such key
+	template <typename K>
+	size_type find_index_(K const& k) const
+	{
+		size_type i = lower_bound_index_(k);
+
+		if (i == keys_.size() || compare_func_(k, keys_[i]))
+			return keys_.size();
+		return i;
+	}
+
+	iterator iterator_at_(size_type i)
+	{
+		return iterator(keys_.data() + i, values_.data() + i);
+	}
+
+	const_iterator iterator_at_(size_type i) const
+	{
+		return const_iterator(keys_.data() + i, values_.data() + i);
+	}
+
+	size_type index_of_(const_iterator it) const
+	{
+		return it.key_ - keys_.data();
+	}
+
+	iterator insert_at_(size_type i, Key const& k, Value const& v)
+	{
+		keys_.insert(keys_.begin() + i, k);
+		try
+		{
+			values_.insert(values_.begin() + i, v);
+		}
+		catch (...)
+		{
+			keys_.erase(keys_.begin() + i);
+			throw;
+		}
+		return iterator_at_(i);
+	}
+
+  public:
+	/*Constructor*/ flat_map(Alloc alloc = Alloc()) :
+		keys_(key_alloc_t(alloc)),
+		values_(value_alloc_t(alloc))
+	{ }
+
+	template <typename InputIt>
+	/*Range Constructor*/ flat_map(InputIt first, InputIt last, KeyCmpFn const& comp = KeyCmpFn(), Alloc alloc = Alloc()) :
+		keys_(key_alloc_t(alloc)),
+		values_(value_alloc_t(alloc)),
+		compare_func_(comp)
+	{
+		insert_many(first, last);
+	}
+
+	// The compiler generated copy constructor, assignment and destructor do the right thing
+
+	mapped_type& operator[]( const Key& key )
+	{
+		// Using operator[] requires that the mapped type be default constructible
+		size_type i = lower_bound_index_(key);
+
+		if (i == keys_.size() || compare_func_(key, keys_[i]))
+			insert_at_(i, key, mapped_type());
+		return values_[i];
+	}
+
+	mapped_type& at( const Key& key )
+	{
+		size_type i = find_index_(key);
+
+		if (i == keys_.size())
+			throw std::out_of_range("flat_map::at");
+		return values_[i];
+	}
+
+	mapped_type const& at( const Key& key ) const
+	{
+		size_type i = find_index_(key);
+
+		if (i == keys_.size())
+			throw std::out_of_range("flat_map::at");
+		return values_[i];
+	}
+
+	// MODIFIERS
+
+	void clear()
+	{
+		keys_.clear();
+		values_.clear();
+	}
+
+	void reserve(size_type n)
+	{
+		keys_.reserve(n);
+		values_.reserve(n);
+	}
+
+	// Linear, everything after the new element moves one slot
+	ft::pair<iterator, bool> insert(value_type const& val)
+	{
+		size_type i = lower_bound_index_(val.first);
+
+		if (i < keys_.size() && !compare_func_(val.first, keys_[i]))
+			return ft::make_pair(iterator_at_(i), false);
+		return ft::make_pair(insert_at_(i, val.first, val.second), true);
+	}
+
+	// The hint is of no use, finding the slot is not the expensive part
+	iterator insert(iterator hint, value_type const& val)
+	{
+		(void)hint;
+		return insert(val).first;
+	}
+
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last)
+	{
+		insert_many(first, last);
+	}
+
+	// Copies [first, last) aside, sorts the newcomers and merges them with the current
+	// content in one pass, O(n + k log k) instead of k linear inserts
+	// As with insert, keys already there keep their value, and among equal new keys the first one wins
+	// Everything is built next to the map and swapped in at the end, a throw leaves it as it was
+	template <typename InputIt>
+	void insert_many(InputIt first, InputIt last)
+	{
+		keys_t   added_keys(keys_.get_allocator());
+		values_t added_values(values_.get_allocator());
+
+		for (; first != last; ++first)
+		{
+			added_keys.push_back(first->first);
+			added_values.push_back(first->second);
+		}
+		if (added_keys.empty())
+			return;
+
+		// Sorting positions instead of elements keeps keys and values together
+		indices_t order;
+		order.reserve(added_keys.size());
+		for (size_type i = 0; i < added_keys.size(); ++i)
+			order.push_back(i);
+		std::sort(order.data(), order.data() + order.size(), index_compare_(added_keys, compare_func_));
+
+		keys_t   keys(keys_.get_allocator());
+		values_t values(values_.get_allocator());
+		keys.reserve(keys_.size() + added_keys.size());
+		values.reserve(values_.size() + added_values.size());
+
+		size_type old_i = 0;
+		size_type new_i = 0;
+		while (old_i < keys_.size() || new_i < order.size())
+		{
+			bool take_new;
+			if (new_i == order.size())
+				take_new = false;
+			else if (old_i == keys_.size())
+				take_new = true;
+			else if (compare_func_(added_keys[order[new_i]], keys_[old_i]))
+				take_new = true;
+			else
+			{
+				if (!compare_func_(keys_[old_i], added_keys[order[new_i]])) // Same key, the old one stays
+					++new_i;
+				take_new = false;
+			}
+
+			Key const&   key   = take_new ? added_keys[order[new_i]] : keys_[old_i];
+			Value const& value = take_new ? added_values[order[new_i]] : values_[old_i];
+			if (take_new)
+				++new_i;
+			else
+				++old_i;
+			if (!keys.empty() && !compare_func_(keys.back(), key)) // Same key as the one just taken
+				continue;
+			keys.push_back(key);
+			values.push_back(value);
+		}
+		keys_.swap(keys);
+		values_.swap(values);
+	}
+
+	size_type erase(Key const& k)
+	{
+		size_type i = find_index_(k);
+
+		if (i == keys_.size())
+			return 0;
+		keys_.erase(keys_.begin() + i);
+		values_.erase(values_.begin() + i);
+		return 1;
+	}
+
+	void erase( iterator it )
+	{
+		size_type i = index_of_(it);
+
+		keys_.erase(keys_.begin() + i);
+		values_.erase(values_.begin() + i);
+	}
+
+	void erase( iterator first, iterator last )
+	{
+		size_type i = index_of_(first);
+		size_type j = index_of_(last);
+
+		keys_.erase(keys_.begin() + i, keys_.begin() + j);
+		values_.erase(values_.begin() + i, values_.begin() + j);
+	}
+
+	void swap( flat_map& other )
+	{
+		keys_.swap(other.keys_);
+		values_.swap(other.values_);
+		std::swap(compare_func_, other.compare_func_);
+	}
+
+	/* CAPACITY */
+
+	bool empty() const
+	{
+		return keys_.empty();
+	}
+
+	size_type size() const
+	{
+		return keys_.size();
+	}
+
+	size_type max_size() const
+	{
+		return keys_.max_size();
+	}
+
+	size_type capacity() const
+	{
+		return keys_.capacity();
+	}
+
+	/* LOOKUP */
+
+	size_type count( const Key& key ) const
+	{
+		if (find_index_(key) == keys_.size())
+			return 0;
+		return 1;
+	}
+
+	iterator find( const Key& key )
+	{
+		return iterator_at_(find_index_(key));
+	}
+
+	const_iterator find( const Key& key ) const
+	{
+		return iterator_at_(find_index_(key));
+	}
+
+	ft::pair<iterator,iterator> equal_range( const Key& key )
+	{
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+	ft::pair<const_iterator,const_iterator> equal_range( const Key& key ) const
+	{
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+	/* Returns lower bound not less than key */
+	iterator lower_bound( const Key& key )
+	{
+		return iterator_at_(lower_bound_index_(key));
+	}
+
+	/* Returns lower bound not less than key */
+	const_iterator lower_bound( const Key& key ) const
+	{
+		return iterator_at_(lower_bound_index_(key));
+	}
+
+	/* Returns iterator to the first element greater than key */
+	iterator upper_bound( const Key& key )
+	{
+		return iterator_at_(upper_bound_index_(key));
+	}
+
+	/* Returns iterator to the first element greater than key */
+	const_iterator upper_bound( const Key& key ) const
+	{
+		return iterator_at_(upper_bound_index_(key));
+	}
+
+	/* Heterogeneous lookup, only there if KeyCmpFn has an is_transparent member type */
+
+	template <typename K>
+	typename if_transparent_<K, size_type>::type count( const K& key ) const
+	{
+		if (find_index_(key) == keys_.size())
+			return 0;
+		return 1;
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type find( const K& key )
+	{
+		return iterator_at_(find_index_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type find( const K& key ) const
+	{
+		return iterator_at_(find_index_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, ft::pair<iterator,iterator> >::type equal_range( const K& key )
+	{
+		return ft::make_pair(iterator_at_(lower_bound_index_(key)), iterator_at_(upper_bound_index_(key)));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, ft::pair<const_iterator,const_iterator> >::type equal_range( const K& key ) const
+	{
+		return ft::make_pair(iterator_at_(lower_bound_index_(key)), iterator_at_(upper_bound_index_(key)));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type lower_bound( const K& key )
+	{
+		return iterator_at_(lower_bound_index_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type lower_bound( const K& key ) const
+	{
+		return iterator_at_(lower_bound_index_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type upper_bound( const K& key )
+	{
+		return iterator_at_(upper_bound_index_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type upper_bound( const K& key ) const
+	{
+		return iterator_at_(upper_bound_index_(key));
+	}
+
+	/* OBSERVERS */
+
+	allocator_type get_allocator() const
+	{
+		return allocator_type(keys_.get_allocator()); // Implicit conversion
+	}
+
+	key_compare key_comp() const
+	{
+		return compare_func_;
+	}
+
+	// The underlying sorted arrays
+	keys_t const& keys() const
+	{
+		return keys_;
+	}
+
+	values_t const& values() const
+	{
+		return values_;
+	}
+
+	/* NESTED ITERATOR CLASSES */
+
+  protected:
+	// A key and its value, one pointer into each array
+	template <typename MaybeConstValue>
+	class flat_iterator
+	{
+	  public:
+		typedef ft::pair<const Key, MaybeConstValue>                 value_type;
+		typedef flat_reference<MaybeConstValue>                       reference;
+		typedef random_access_iterator_tag                    iterator_category;
+		typedef std::ptrdiff_t                                  difference_type;
+
+		// Dereferencing makes a pair of references on the spot, -> has to keep one alive
+		class pointer
+		{
+			reference ref_;
+
+		  public:
+			explicit pointer(reference ref) : ref_(ref) { }
+			reference const *operator->() const { return &ref_; }
+		};
+
+	  protected:
+		friend class flat_map; // So that it can get to the index behind an iterator
+
+		/* STATE */
+		Key const       *key_;
+		MaybeConstValue *value_;
+
+	  public:
+
+		/* Default Constructor */ flat_iterator()
+			: key_(NULL), value_(NULL)
+		{ }
+
+		/* Constructor */ flat_iterator(Key const *key, MaybeConstValue *value)
+			: key_(key), value_(value)
+		{ }
+
+		/* Conversion */ operator flat_map<Key, Value, KeyCmpFn, Alloc>::const_iterator() const
+		{
+			return flat_map<Key, Value, KeyCmpFn, Alloc>::const_iterator(key_, value_);
+		}
+
+		reference operator*() const { return reference(*key_, *value_); }
+
+		pointer operator->() const { return pointer(**this); }
+
+		reference operator[](difference_type i) const { return reference(key_[i], value_[i]); }
+
+		bool operator==(flat_iterator const &rhs) const { return key_ == rhs.key_; }
+		bool operator!=(flat_iterator const &rhs) const { return key_ != rhs.key_; }
+		bool operator<(flat_iterator const &rhs) const { return key_ < rhs.key_; }
+		bool operator>(flat_iterator const &rhs) const { return key_ > rhs.key_; }
+		bool operator<=(flat_iterator const &rhs) const { return key_ <= rhs.key_; }
+		bool operator>=(flat_iterator const &rhs) const { return key_ >= rhs.key_; }
+
+		flat_iterator &operator++()
+		{
+			++key_;
+			++value_;
+			return *this;
+		}
+
+		flat_iterator &operator--()
+		{
+			--key_;
+			--value_;
+			return *this;
+		}
+
+		flat_iterator operator++(int)
+		{
+			flat_iterator tmp = *this;
+			operator++();
+			return tmp;
+		}
+
+		flat_iterator operator--(int)
+		{
+			flat_iterator tmp = *this;
+			operator--();
+			return tmp;
+		}
+
+		flat_iterator &operator+=(difference_type n)
+		{
+			key_   += n;
+			value_ += n;
+			return *this;
+		}
+
+		flat_iterator &operator-=(difference_type n)
+		{
+			key_   -= n;
+			value_ -= n;
+			return *this;
+		}
+
+		flat_iterator operator+(difference_type n) const { return flat_iterator(key_ + n, value_ + n); }
+		flat_iterator operator-(difference_type n) const { return flat_iterator(key_ - n, value_ - n); }
+		difference_type operator-(flat_iterator const &rhs) const { return key_ - rhs.key_; }
+	};
+
+  public:
+	iterator begin()
+	{
+		return iterator_at_(0);
+	}
+
+	iterator end()
+	{
+		return iterator_at_(keys_.size());
+	}
+
+	const_iterator begin() const
+	{
+		return iterator_at_(0);
+	}
+
+	const_iterator end() const
+	{
+		return iterator_at_(keys_.size());
+	}
+}; // class flat_map
+
+template< class Key, class T, class Compare, class Allocator >
+bool	operator==( flat_map< Key, T, Compare, Allocator > const & x, flat_map< Key, T, Compare, Allocator> const & y )
+{
+	return x.keys() == y.keys() && x.values() == y.values();
+}
+
+template< class Key, class T, class Compare, class Allocator >
+bool	operator!=( flat_map< Key, T, Compare, Allocator > const & x, flat_map< Key, T, Compare, Allocator> const & y )
+{
+	return !( x == y );
+}
+
+} // namespace ft
+
+// specialized algorithms
+namespace std {
+template< class Key, class T, class Compare, class Allocator >
+void	swap( ft::flat_map< Key, T, Compare, Allocator > & x, ft::flat_map< Key, T, Compare, Allocator > & y )
+{
+	x.swap( y );
+	return ;
+}
+} // namespace std
+
+#endif /* FLAT_MAP_HPP */
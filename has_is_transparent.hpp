@@ -0,0 +1,25 @@
+#ifndef HAS_IS_TRANSPARENT_HPP
+#define HAS_IS_TRANSPARENT_HPP
+
+//Checks whether the comparator T declares a nested is_transparent type, meaning it can compare keys
+//against other key-like types (think std::string against const char*) without converting them first.
+//Provides the member constant value which is equal to true in that case, false otherwise.
+
+template <typename T>
+struct has_is_transparent
+{
+private:
+	typedef char yes_;
+	typedef struct { char pad[2]; } no_;
+
+	// Only viable when U::is_transparent names a type, otherwise SFINAE falls back on the ellipsis
+	template <typename U>
+	static yes_ test_(typename U::is_transparent*);
+	template <typename U>
+	static no_ test_(...);
+
+public:
+	static bool const value = sizeof(test_<T>(0)) == sizeof(yes_);
+};
+
+#endif /* HAS_IS_TRANSPARENT_HPP */
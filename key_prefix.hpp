@@ -0,0 +1,209 @@
+#ifndef KEY_PREFIX_HPP
+#define KEY_PREFIX_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#include "three_way_compare.hpp"
+
+namespace ft
+{
+
+//What tree nodes keep next to their key so that lookups go down faster, and how a lookup uses it.
+//slot is a base of every node, store() is called whenever the node's key is set.
+//probe carries one key down from the root and compares it against the nodes it meets, in order.
+//The primary template keeps nothing and asks three_way_compare, or the comparator itself, at each node.
+template <typename KeyCmpFn, typename Enable = void>
+struct key_prefix
+{
+	struct slot
+	{
+		template <typename Key>
+		void store(Key const&) { }
+	};
+
+	template <typename K>
+	class probe
+	{
+		K const& k_;
+
+	  public:
+		/*Constructor*/ explicit probe(K const& k) : k_(k) { }
+
+		// Negative, zero or positive as k sorts before, with or after key
+		template <typename Key>
+		int compare(KeyCmpFn const& comp, Key const& key, slot const&)
+		{
+			return three_way_compare<KeyCmpFn>::compare(comp, k_, key);
+		}
+
+		// k < key
+		template <typename Key>
+		bool before(KeyCmpFn const& comp, Key const& key, slot const&)
+		{
+			return comp(k_, key);
+		}
+
+		// key < k
+		template <typename Key>
+		bool after(KeyCmpFn const& comp, Key const& key, slot const&)
+		{
+			return comp(key, k_);
+		}
+	};
+};
+
+//Byte strings in std::less order: nodes keep the first 8 bytes of their key as a big-endian integer,
+//zero padded, so that two different prefixes are ordered like their strings by one integer comparison.
+//Probes also remember how many bytes they share with the closest keys they went right and left of.
+//Every key in between shares at least the smaller of the two, so those bytes are never read again.
+//char_traits<char> compares as unsigned char, which is what the integers do.
+template <typename Alloc>
+struct key_prefix<std::less<std::basic_string<char, std::char_traits<char>, Alloc> > >
+{
+	typedef std::basic_string<char, std::char_traits<char>, Alloc> string_type;
+	typedef std::less<string_type>                                 compare_type;
+	typedef unsigned long long                                     word_type;
+
+	static std::size_t const width = sizeof(word_type);
+
+	// width bytes from p, the first one in the high byte
+	static word_type load_(char const *p)
+	{
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		word_type w;
+
+		std::memcpy(&w, p, width); // One unaligned load
+		return __builtin_bswap64(w);
+#else
+		word_type w = 0;
+
+		for (std::size_t i = 0; i < width; ++i)
+			w = (w << 8) | static_cast<unsigned char>(p[i]);
+		return w;
+#endif
+	}
+
+	// How many high bytes of a non zero word are zero
+	static std::size_t zero_bytes_(word_type w)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<std::size_t>(__builtin_clzll(w)) / 8;
+#else
+		std::size_t n = 0;
+
+		for (; (w >> (8 * (width - 1))) == 0; w <<= 8)
+			++n;
+		return n;
+#endif
+	}
+
+	// Where a and b first differ at or after from, n when their first n bytes are the same
+	static std::size_t mismatch_(char const *a, char const *b, std::size_t from, std::size_t n)
+	{
+		for (; from + width <= n; from += width) // A word at a time
+		{
+			word_type diff = load_(a + from) ^ load_(b + from);
+			if (diff != 0)
+				return from + zero_bytes_(diff);
+		}
+		while (from < n && a[from] == b[from])
+			++from;
+		return from;
+	}
+
+	static word_type prefix_of(string_type const& s)
+	{
+		char const  *p = s.data();
+		std::size_t n  = s.size();
+
+		if (n >= width)
+			return load_(p);
+		word_type w = 0;
+		for (std::size_t i = 0; i < width; ++i)
+			w = (w << 8) | (i < n ? static_cast<unsigned char>(p[i]) : 0u);
+		return w;
+	}
+
+	struct slot
+	{
+		word_type prefix;
+
+		void store(string_type const& key) { prefix = prefix_of(key); }
+	};
+
+	// K is always string_type, std::less<string_type> is not transparent
+	template <typename K>
+	class probe
+	{
+		string_type const& k_;
+		word_type          prefix_;
+		std::size_t        low_;  // Bytes shared with the last key k went right of
+		std::size_t        high_; // and with the last one it went left of
+
+		// Order of k against key, common is how many bytes they share
+		int order_(string_type const& key, slot const& s, std::size_t& common) const
+		{
+			std::size_t n      = k_.size() < key.size() ? k_.size() : key.size();
+			std::size_t shared = low_ < high_ ? low_ : high_;
+
+			if (shared < width && prefix_ != s.prefix) // Told apart within the prefixes
+			{
+				common = zero_bytes_(prefix_ ^ s.prefix);
+				common = common < n ? common : n; // Padding is not part of the strings
+				return prefix_ < s.prefix ? -1 : 1;
+			}
+			std::size_t from = n < width ? n : width; // Equal prefixes, equal bytes up to here
+
+			common = mismatch_(k_.data(), key.data(), shared > from ? shared : from, n);
+			if (common < n)
+				return static_cast<unsigned char>(k_[common]) < static_cast<unsigned char>(key[common]) ? -1 : 1;
+			return static_cast<int>(k_.size() > key.size()) - static_cast<int>(k_.size() < key.size());
+		}
+
+	  public:
+		/*Constructor*/ explicit probe(string_type const& k) :
+			k_(k),
+			prefix_(prefix_of(k)),
+			low_(0),
+			high_(0)
+		{ }
+
+		// The caller goes left of key when k is before it and right when k is after it,
+		// a key equal to k ends the descent
+		int compare(compare_type const&, string_type const& key, slot const& s)
+		{
+			std::size_t common;
+			int         order = order_(key, s, common);
+
+			(order < 0 ? high_ : low_) = common;
+			return order;
+		}
+
+		// The caller goes left of key when it is true, right otherwise, equal keys included
+		bool before(compare_type const&, string_type const& key, slot const& s)
+		{
+			std::size_t common;
+			bool        left = order_(key, s, common) < 0;
+
+			(left ? high_ : low_) = common;
+			return left;
+		}
+
+		// The caller goes right of key when it is true, left otherwise, equal keys included
+		bool after(compare_type const&, string_type const& key, slot const& s)
+		{
+			std::size_t common;
+			bool        right = order_(key, s, common) > 0;
+
+			(right ? low_ : high_) = common;
+			return right;
+		}
+	};
+};
+
+} // namespace ft
+
+#endif /* KEY_PREFIX_HPP */
@@ -2,12 +2,18 @@
 #include "test_vector.hpp"
 #include "test_stack.hpp"
 #include "test_map.hpp"
+#include "test_btree_map.hpp"
+#include "test_flat_map.hpp"
+#include "test_compact_map.hpp"
 
 int main()
 {
 	//test_vector();
 	//test_stack();
 	test_map();
+	test_btree_map();
+	test_flat_map();
+	test_compact_map();
 }
 
 
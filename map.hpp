@@ -1,26 +1,42 @@
 #ifndef MAP_HPP
 #define MAP_HPP
 
+#include <algorithm>
 #include <cstddef>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <new>
 #include <sstream>
 #include <stack>
 #include <stdexcept>
 #include <utility>
+#include <vector>
+#if __cplusplus >= 201103L
+# include <system_error>
+# include <thread>
+# include <tuple>
+#endif
 
 #include "iterator_traits.hpp"
 #include "reverse_iterator.hpp"
 #include "pair.hpp"
 #include "algorithm.hpp"
+#include "enable_if.hpp"
+#include "has_is_transparent.hpp"
+#include "node_pool.hpp"
+#include "map_augment.hpp"
+#include "three_way_compare.hpp"
+#include "key_prefix.hpp"
 
 namespace ft
 {
 
+// Augment picks what nodes keep about their subtree, see map_augment.hpp
 template <typename Key, typename Value, typename KeyCmpFn = std::less<Key>,
-          typename Alloc = std::allocator<std::pair<const Key, Value> > >
+          typename Alloc = std::allocator<std::pair<const Key, Value> >,
+          typename Augment = no_augment>
 class map
 {
   protected:
@@ -31,6 +47,8 @@ class map
 	class aat_iterator;
 
   public:
+	class node_handle;
+
 	typedef Key                                                        key_type;
 	typedef Value                                                   mapped_type;
 	typedef ft::pair<const Key, Value>                               value_type;
@@ -40,30 +58,47 @@ class map
 	typedef KeyCmpFn                                                key_compare;
 	typedef value_type&                                               reference;
 	typedef value_type const&                                   const_reference;
+#if __cplusplus >= 201103L
+	typedef typename std::allocator_traits<Alloc>::pointer              pointer;
+	typedef typename std::allocator_traits<Alloc>::const_pointer  const_pointer;
+#else
 	typedef typename Alloc::pointer                                     pointer;
 	typedef typename Alloc::const_pointer                         const_pointer;
+#endif
 	typedef aat_iterator<Value>   			                           iterator;
 	typedef aat_iterator<const Value>                            const_iterator;
 	typedef ft::reverse_iterator<iterator>                     reverse_iterator;
 	typedef ft::reverse_iterator<const_iterator>         const_reverse_iterator;
+	typedef typename aggregate_result<Augment>::type             aggregate_type;
+	typedef node_handle                                               node_type;
 
   protected:
 	// the template keyword is only here so that the < can be correctly parsed
 	typedef ft::pair<const Key, Value>                              pair_type_t;
 	typedef AA_node                                                      node_t;
 	typedef AA_node *                                                node_ptr_t;
+#if __cplusplus >= 201103L
+	typedef typename
+	std::allocator_traits<Alloc>::template rebind_alloc<node_t>    node_alloc_t;
+#else
 	typedef typename
 	Alloc::template rebind<node_t>::other                          node_alloc_t;
-
-	// Were we able to use c++11, we would have used std::allocator_traits like this
-	// typedef typename
-	// std::allocator_traits<Alloc>::template rebind_alloc<node_t>          node_allocator_type;
-	
+#endif
+	typedef node_pool<node_t, node_alloc_t>                         node_pool_t;
+	typedef node_augment<Augment>                                     augment_t;
+	typedef key_prefix<KeyCmpFn>                                       prefix_t;
+
+	// Result when KeyCmpFn is transparent, no overload otherwise
+	// Taking the key type K makes the check happen at the call instead of when the map is instantiated
+	template <typename K, typename Result>
+	struct if_transparent_ : enable_if<has_is_transparent<KeyCmpFn>::value, Result>
+	{
+	};
 
 	/* STATE */
 	node_ptr_t          root_;
 	size_type           size_;
-	node_alloc_t  node_alloc_;
+	node_pool_t         node_pool_;
 	key_compare         compare_func_;
 
 	// Singleton for the NIL node 
@@ -79,7 +114,8 @@ class map
 	// This allows us to use our tree with non default-constructible Key and Value
 	// because using an having a Key and Value as members would force the call
 	// of Key() and Value() at the time of creation of the NIL node
-	struct AA_base_node
+	// The augment_t base is empty unless Augment asks for something
+	struct AA_base_node : public augment_t
 	{
 		AA_node *left;
 		AA_node *right;
@@ -104,31 +140,68 @@ class map
 		{ }
 	};
 
-	struct AA_node : public AA_base_node
+	// Nodes are born unlinked, attach_() gives them their parent
+	// The prefix_t slot is what lookups read before the key, empty unless KeyCmpFn has a use for it
+	struct AA_node : public AA_base_node, public prefix_t::slot
 	{
-		std::pair<Key, Value> pair;
-
-		/*Constructor*/ AA_node(Key k, Value v, AA_node *p) :
-			AA_base_node(NIL, NIL, p, 1),
+		value_type pair; // What iterators hand out, as is
+
+#if __cplusplus >= 201103L
+		// The element is built right inside the node out of whatever its constructor takes
+		template <typename... Args>
+		/*Constructor*/ explicit AA_node(Args&&... args) :
+			AA_base_node(NIL, NIL, NIL, 1),
+			pair(std::forward<Args>(args)...)
+		{
+			this->recount(NIL, NIL, pair.second); // A lone node is its own subtree
+			this->store(pair.first);
+		}
+#else
+		/*Constructor*/ AA_node(Key const& k, Value const& v) :
+			AA_base_node(NIL, NIL, NIL, 1),
 			pair(k, v)
-		{ }
+		{
+			this->recount(NIL, NIL, pair.second); // A lone node is its own subtree
+			this->store(pair.first);
+		}
+#endif
 
-		typename std::pair<Key, Value>::first_type & key() { return pair.first; }
-		typename std::pair<Key, Value>::second_type & value() { return pair.second;}
+		Key const& key() { return pair.first; }
+		Value& value() { return pair.second;}
 	};
 
+	// The header is the root's parent and what end() points to
+	// Its left and right are the leftmost and rightmost nodes, itself when empty
+	AA_base_node        header_;
+
 	/* HELPERS */
 
-	static node_ptr_t update_root(node_ptr_t root)
+	node_ptr_t header_node_() const
+	{
+		return static_cast<node_ptr_t>(const_cast<AA_base_node *>(&header_));
+	}
+
+	// The header is the only node below NIL's level
+	static bool is_header_(node_ptr_t node)
+	{
+		return node->level < 0;
+	}
+
+	void reset_header_()
+	{
+		header_.parent = NIL;
+		header_.left   = header_node_();
+		header_.right  = header_node_();
+		header_.level  = -1;
+	}
+
+	// Points the root back at our own header, needed once roots have been exchanged
+	void adopt_root_()
 	{
-		 //If the the parent of the root is NIL
-		 //while (root != NIL)
-		 //   root = root->parent;
-		
-		 //If the root is its own parent use instead :
-		while (root != NIL && root != root->parent)
-			root = root->parent;
-		return root;
+		if (root_ == NIL)
+			reset_header_();
+		else
+			root_->parent = header_node_();
 	}
 
 	static node_ptr_t leftmost_(node_ptr_t node)
@@ -145,26 +218,24 @@ class map
 		return node;
 	}
 
-	static node_ptr_t in_order_successor_(node_ptr_t node)
+	// In-order neighbours found through parent links, the header when there is none
+	// Amortized O(1) when walking through the tree
+	static node_ptr_t next_node_(node_ptr_t node)
 	{
-		if (node->right == NIL)
-			return node;
-		else
-			node = node->right;
-		while (node->left != NIL)
-			node = node->left;
-		return node;
+		if (node->right != NIL)
+			return leftmost_(node->right);
+		while (!is_header_(node->parent) && node == node->parent->right)
+			node = node->parent;
+		return node->parent;
 	}
 
-	static node_ptr_t in_order_predecessor_(node_ptr_t node)
+	static node_ptr_t prev_node_(node_ptr_t node)
 	{
-		if (node->left == NIL)
-			return node;
-		else
-			node = node->left;
-		while (node->right != NIL)
-			node = node->right;
-		return node;
+		if (node->left != NIL)
+			return rightmost_(node->left);
+		while (!is_header_(node->parent) && node == node->parent->left)
+			node = node->parent;
+		return node->parent;
 	}
 
 	/*TREE BALANCING*/
@@ -189,6 +260,8 @@ class map
 
 		oldroot->left        = newroot->right;
 		newroot->right       = oldroot;
+		recount_(oldroot); // Bottom-up, newroot is now above
+		recount_(newroot);
 
 		// return pointer of the node that came out on top
 		return newroot;
@@ -214,6 +287,8 @@ class map
 
 		oldroot->right       = newroot->left;
 		newroot->left        = oldroot;
+		recount_(oldroot);
+		recount_(newroot);
 
 		// promote newroot to next higher level
 		newroot->level += 1;
@@ -234,184 +309,1729 @@ class map
 		}
 	}
 
-	// Update node's level and then three skews and two splits do the trick
+	// Once node's level has been updated, three skews and two splits do the trick
+	// NIL is never written to, set operations may run this on several threads
 	static node_ptr_t fixup_after_delete_(node_ptr_t node)
 	{
-		update_level_(node);
-		node               = skew_(node);
-		node->right        = skew_(node->right);
-		node->right->right = skew_(node->right->right);
-		node               = split_(node);
-		node->right        = split_(node->right);
+		node = skew_(node);
+		if (node->right != NIL)
+		{
+			node->right = skew_(node->right);
+			if (node->right->right != NIL)
+				node->right->right = skew_(node->right->right);
+		}
+		node = split_(node);
+		if (node->right != NIL)
+			node->right = split_(node->right);
 		return (node);
 	}
 
-	/*INSERTION & DELETION*/
+	// Works out what node keeps about its subtree, from its children
+	static void recount_(node_ptr_t node)
+	{
+		node->recount(node->left, node->right, node->value());
+	}
 
-	iterator insert_(Key const& k, Value const& v)
+	// Same for node and every ancestor, rotations keep them right afterwards
+	static void recount_path_(node_ptr_t node)
+	{
+		if (augment_t::stores_nothing)
+			return ;
+		for (; !is_header_(node); node = node->parent)
+			recount_(node);
+	}
+
+	// Hooks new_top where old_top used to hang under parent
+	void relink_(node_ptr_t parent, node_ptr_t old_top, node_ptr_t new_top)
 	{
-		node_ptr_t ret = NULL;;
+		if (is_header_(parent))
+			root_ = new_top;
+		else if (parent->left == old_top)
+			parent->left = new_top;
+		else
+			parent->right = new_top;
+		if (new_top != NIL)
+			new_top->parent = parent;
+	}
 
-		root_ = insert_(k, v, NIL, root_, &ret);
-		// Need this line if we want root to be its own parent, need to change update_root if commmented out
-		root_->parent = root_;
-		return iterator(root_, ret);
+	// Negative, zero or positive as a sorts before, with or after b, in one comparison
+	// when three_way_compare knows how for KeyCmpFn
+	template <typename A, typename B>
+	int compare_(A const& a, B const& b) const
+	{
+		return three_way_compare<KeyCmpFn>::compare(compare_func_, a, b);
 	}
 
-	node_ptr_t insert_(Key const& k, Value const& v, node_ptr_t parent, node_ptr_t current_node, node_ptr_t *ret)
+	// Lookups return the header when there is no such node, so that it makes an end() iterator
+	// They take any K the comparator accepts, which is only ever something else than Key when it is transparent
+	template <typename K>
+	node_ptr_t find_node_(K const& k) const
 	{
-		if (current_node == NIL) // fell out of the tree?
+		node_ptr_t                           current = root_;
+		typename prefix_t::template probe<K> probe(k);
+
+		while (current != NIL)
 		{
-			++size_;
-			// create a new leaf node
-			current_node = node_alloc_.allocate(1);
-			node_alloc_.construct(current_node, node_t(k, v, parent));
-			*ret = current_node;
+			int order = probe.compare(compare_func_, current->key(), *current);
+			if (order == 0)
+				return current;
+			current = order < 0 ? current->left : current->right;
 		}
-		else if (compare_func_(k, current_node->key()))        // key is smaller?
-			current_node->left = insert_(k, v, current_node, current_node->left, ret);   // ->insert left
-		else if (compare_func_(current_node->key(), k))         // key is larger?
-			current_node->right = insert_(k, v, current_node, current_node->right, ret); // ->insert right
-		else
+		return header_node_();
+	}
+
+	// How many lookups find_batch() keeps going at once, enough for their misses to overlap
+	static size_type const batch_width_ = 16;
+
+	static void prefetch_(node_ptr_t node)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(node);
+#else
+		(void)node;
+#endif
+	}
+
+	// find_node_() for batch_width_ keys at a time, taking turns one level down each
+	// A lookup asks for its next node ahead of time and compares again only once all the others
+	// have had their turn, by then the node is likely in cache and the misses went on side by side
+	// Results are written once the whole group is done so that they come out in order
+	template <typename It, typename KeyIt, typename OutIt>
+	OutIt find_batch_(KeyIt first, KeyIt last, OutIt out) const
+	{
+		KeyIt      keys[batch_width_];
+		node_ptr_t current[batch_width_]; // Never NIL, the header once a key is known to be missing
+		size_type  going[batch_width_];   // Lookups still on their way down, in no particular order
+
+		while (first != last)
+		{
+			size_type n      = 0;
+			size_type active = 0;
+
+			for (; n < batch_width_ && first != last; ++n, ++first)
+			{
+				keys[n]    = first;
+				current[n] = root_ == NIL ? header_node_() : root_;
+				if (root_ != NIL)
+					going[active++] = n;
+			}
+			while (active > 0)
+			{
+				for (size_type j = 0; j < active; )
+				{
+					size_type  i    = going[j];
+					node_ptr_t node  = current[i];
+					int        order = compare_(*keys[i], node->key());
+					node_ptr_t next;
+
+					if (order == 0) // Found, current[i] stays on it
+						next = node;
+					else
+						next = order < 0 ? node->left : node->right;
+					if (next == NIL)
+						current[i] = header_node_();
+					if (next == NIL || next == node)
+					{
+						going[j] = going[--active];
+						continue;
+					}
+					prefetch_(next);
+					current[i] = next;
+					++j;
+				}
+			}
+			for (size_type i = 0; i < n; ++i)
+				*out++ = It(current[i]);
+		}
+		return out;
+	}
+
+	// First node whose key is not less than k
+	template <typename K>
+	node_ptr_t lower_bound_node_(K const& k) const
+	{
+		node_ptr_t                           current = root_;
+		node_ptr_t                           best    = header_node_();
+		typename prefix_t::template probe<K> probe(k);
+
+		while (current != NIL)
 		{
-			current_node->value() = v;
-			*ret = current_node;
+			if (probe.after(compare_func_, current->key(), *current)) // Too small, look right
+				current = current->right;
+			else // Candidate, but there may be a smaller one on the left
+			{
+				best    = current;
+				current = current->left;
+			}
 		}
-		return split_(skew_(current_node)); // restructure and return result
+		return best;
 	}
 
-	// This implementation does not bother with special cases that do not need rebalancing
-	node_ptr_t remove_(Key k, node_ptr_t node)
+	// First node whose key is greater than k
+	template <typename K>
+	node_ptr_t upper_bound_node_(K const& k) const
 	{
-		if (node == NIL) // Fell out of tree, key does not exist
-			return node; // No-op
-		else if (compare_func_(k, node->key()))
-			node->left = remove_(k, node->left); // Look in left subtree
-		else if (compare_func_(node->key(), k))
-			node->right = remove_(k, node->right); // Look in right subtree
-		else                                       // Found it !
+		node_ptr_t                           current = root_;
+		node_ptr_t                           best    = header_node_();
+		typename prefix_t::template probe<K> probe(k);
+
+		while (current != NIL)
 		{
-			if (node->right == NIL && node->left == NIL) // It's a leaf node, remove it
+			if (probe.before(compare_func_, current->key(), *current)) // Candidate, but there may be a smaller one on the left
 			{
-				node_alloc_.destroy(node);
-				node_alloc_.deallocate(node, 1);
-				--size_;
-				return NIL;
+				best    = current;
+				current = current->left;
 			}
-			else if (node->left == NIL) // No left child ? Means it is a black leaf node. Replace with its red child
+			else // Not greater, look right
+				current = current->right;
+		}
+		return best;
+	}
+
+	// lower_bound_node_() starting from finger, end() standing for the last node, instead of the root
+	// Climbs to the lowest ancestor the answer can't be outside of, then goes down from there
+	// About O(log d) for an answer d elements away, a sweep over m sorted keys adds up to O(m log(n/m + 1))
+	template <typename K>
+	node_ptr_t lower_bound_from_node_(node_ptr_t finger, K const& k) const
+	{
+		node_ptr_t best = header_node_();
+
+		if (root_ == NIL)
+			return best;
+
+		node_ptr_t current = is_header_(finger) ? header_.right : finger;
+
+		if (compare_func_(current->key(), k)) // Further on, up to a parent on our right that is not less than k
+		{
+			for (; !is_header_(current->parent); current = current->parent)
 			{
-				node->key()   = node->right->key();
-				node->value() = node->right->value();
-				node->right   = remove_(node->right->key(), node->right);
+				if (current == current->parent->left && !compare_func_(current->parent->key(), k))
+				{
+					best = current->parent;
+					break;
+				}
 			}
-			else // Find succesor, copy its values and remove successor instead
+		}
+		else // finger or before, up to a parent on our left that is less than k
+		{
+			for (; !is_header_(current->parent); current = current->parent)
 			{
-				node_ptr_t successor   = in_order_successor_(node);
-				node->key()              = successor->key();
-				node->value()            = successor->value();
-				node->right              = remove_(successor->key(), node->right);
+				if (current == current->parent->right && compare_func_(current->parent->key(), k))
+					break;
 			}
 		}
-		return fixup_after_delete_(node);
+		while (current != NIL)
+		{
+			if (compare_func_(current->key(), k))
+				current = current->right;
+			else
+			{
+				best    = current;
+				current = current->left;
+			}
+		}
+		return best;
 	}
 
-	node_ptr_t clear_(node_ptr_t node)
+	// The node holding k, found from finger, the header if there is none
+	template <typename K>
+	node_ptr_t find_from_node_(node_ptr_t finger, K const& k) const
 	{
-		if (node->left != NIL)
-			node->left = clear_(node->left);
-		if (node->right != NIL)
-			node->right = clear_(node->right);
-		// If both have returned NIL, our node is now a leaf node
-		if (node != NIL && node->right == NIL && node->left == NIL) // It's a leaf node, remove it
+		node_ptr_t node = lower_bound_from_node_(finger, k);
+
+		if (is_header_(node) || compare_func_(k, node->key()))
+			return header_node_();
+		return node;
+	}
+
+	/*NODE CREATION*/
+
+#if __cplusplus >= 201103L
+	template <typename... Args>
+	node_ptr_t new_node_(Args&&... args)
+	{
+		node_ptr_t node = node_pool_.allocate();
+
+		try
 		{
-			delete node;
-			--size_;
-			return NIL;
+			::new (static_cast<void *>(node)) node_t(std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			node_pool_.deallocate(node);
+			throw;
+		}
+		return node;
+	}
+#else
+	node_ptr_t new_node_(Key const& k, Value const& v)
+	{
+		node_ptr_t node = node_pool_.allocate();
+
+		try
+		{
+			::new (static_cast<void *>(node)) node_t(k, v);
+		}
+		catch (...)
+		{
+			node_pool_.deallocate(node);
+			throw;
+		}
+		return node;
+	}
+#endif
+
+	void delete_node_(node_ptr_t node)
+	{
+		node->~node_t();
+		node_pool_.deallocate(node);
+	}
+
+	/*INSERTION & DELETION*/
+
+	// Returns the node holding k if there is one, NIL otherwise
+	// with parent and as_left telling where a node for k would hang
+	node_ptr_t insert_position_(Key const& k, node_ptr_t *parent, bool *as_left) const
+	{
+		node_ptr_t                             current = root_;
+		typename prefix_t::template probe<Key> probe(k);
+
+		*parent  = header_node_();
+		*as_left = false;
+		while (current != NIL) // Walk down to where the key belongs
+		{
+			int order = probe.compare(compare_func_, current->key(), *current);
+
+			*parent  = current;
+			*as_left = order < 0;
+			if (order == 0) // Already there
+				return current;
+			current = *as_left ? current->left : current->right;
 		}
 		return NIL;
 	}
 
-	/* INTERFACE */
+	iterator insert_(Key const& k, Value const& v)
+	{
+		node_ptr_t parent  = NIL;
+		bool       as_left = false;
+		node_ptr_t found = insert_position_(k, &parent, &as_left);
 
-  public:
-	/*Constructor*/ map(Alloc alloc = Alloc()) :
-		root_(NIL),
-		size_(0),
-		node_alloc_(alloc) // node_alloc_ and alloc are different types, implicit conversion thanks to allocator's special ctor
-	{ }
+		if (found != NIL)
+			return iterator(found);
+		return iterator(attach_(new_node_(k, v), parent, as_left));
+	}
 
-	/*Destructor*/ ~map()
+	// insert_position_() that only trusts the hint if k belongs right next to it
+	node_ptr_t hint_position_(node_ptr_t hint, Key const& k, node_ptr_t *parent, bool *as_left) const
 	{
-		this->clear();
+		if (root_ == NIL)
+			return insert_position_(k, parent, as_left);
+		if (is_header_(hint)) // end(), goes after the last one ?
+		{
+			*parent  = header_.right;
+			*as_left = false;
+			if (compare_func_((*parent)->key(), k))
+				return NIL;
+		}
+		else if (compare_func_(k, hint->key())) // Goes right before hint ?
+		{
+			node_ptr_t prev = prev_node_(hint);
+			if (is_header_(prev) || compare_func_(prev->key(), k))
+			{
+				*as_left = hint->left == NIL;
+				*parent  = *as_left ? hint : prev; // prev is the rightmost of hint's left
+				return NIL;
+			}
+		}
+		else if (compare_func_(hint->key(), k)) // Goes right after hint ?
+		{
+			node_ptr_t next = next_node_(hint);
+			if (is_header_(next) || compare_func_(k, next->key()))
+			{
+				*as_left = hint->right != NIL;
+				*parent  = *as_left ? next : hint; // next is the leftmost of hint's right
+				return NIL;
+			}
+		}
+		else // Already there
+			return hint;
+		return insert_position_(k, parent, as_left); // Bad hint, search from the root
 	}
 
-	map operator=(map const& rhs)
+	iterator insert_(node_ptr_t hint, Key const& k, Value const& v)
 	{
-		if (this != &rhs)
+		node_ptr_t parent  = NIL;
+		bool       as_left = false;
+		node_ptr_t found = hint_position_(hint, k, &parent, &as_left);
+
+		if (found != NIL)
+			return iterator(found);
+		return iterator(attach_(new_node_(k, v), parent, as_left));
+	}
+
+	// Hangs a new leaf under parent (the header for an empty tree) and rebalances from there
+	node_ptr_t attach_(node_ptr_t node, node_ptr_t parent, bool as_left)
+	{
+		node->parent = parent;
+		++size_;
+		if (is_header_(parent)) // First node
 		{
-			this->clear();
-			insert(rhs.begin(), rhs.last); // There must be a better way though
+			root_ = node;
+			header_.left  = node;
+			header_.right = node;
+		}
+		else if (as_left)
+		{
+			parent->left = node;
+			if (parent == header_.left)
+				header_.left = node;
+		}
+		else
+		{
+			parent->right = node;
+			if (parent == header_.right)
+				header_.right = node;
+		}
+		recount_path_(parent);
+		rebalance_after_insert_(node);
+		return node;
+	}
+
+	// Hangs node right before next, the header standing for after the last one
+	node_ptr_t attach_before_(node_ptr_t node, node_ptr_t next)
+	{
+		if (root_ == NIL)
+			return attach_(node, header_node_(), false);
+		if (is_header_(next))
+			return attach_(node, header_.right, false);
+		if (next->left == NIL)
+			return attach_(node, next, true);
+		return attach_(node, rightmost_(next->left), false);
+	}
+
+	// A new node only upsets its ancestors through horizontal links
+	// so we skew and split upward until a subtree sits below its parent's level
+	// The header's level is below any node's, which stops us at the root
+	void rebalance_after_insert_(node_ptr_t node)
+	{
+		while (node->level == node->parent->level)
+		{
+			node_ptr_t current = node->parent;
+			node_ptr_t parent  = current->parent;
+
+			node = split_(skew_(current));
+			relink_(parent, current, node);
+		}
+	}
+
+	// Puts succ where node is and node where succ was, succ being the leftmost of node's right subtree
+	// Only links and levels change hands, elements never move between nodes
+	void swap_with_successor_(node_ptr_t node, node_ptr_t succ)
+	{
+		node_ptr_t parent     = node->parent;
+		node_ptr_t succ_right = succ->right;
+
+		std::swap(node->level, succ->level);
+		std::swap(static_cast<augment_t&>(*node), static_cast<augment_t&>(*succ)); // They go with the place, remove_node_ fixes the path
+		if (node->right == succ)
+			succ->right = node;
+		else
+		{
+			succ->parent->left  = node; // succ was a left child
+			node->parent        = succ->parent;
+			succ->right         = node->right;
+			succ->right->parent = succ;
+		}
+		relink_(parent, node, succ);
+		if (succ->right == node)
+			node->parent = succ;
+		succ->left         = node->left;
+		succ->left->parent = succ;
+		node->left         = NIL;
+		node->right        = succ_right;
+		if (succ_right != NIL)
+			succ_right->parent = node;
+	}
+
+	void remove_node_(node_ptr_t node)
+	{
+		unlink_node_(node);
+		delete_node_(node);
+	}
+
+	// Takes node out of the tree, leaving it alive but with stale links
+	// Removal always happens at level 1, on a node that has no left child
+	void unlink_node_(node_ptr_t node)
+	{
+		if (node->left != NIL) // Internal node, move it down to where its successor is first
+			swap_with_successor_(node, leftmost_(node->right));
+
+		node_ptr_t parent      = node->parent;
+		node_ptr_t replacement = node->right; // NIL or a red node on the same level
+
+		// Extremes have no left child, so they never needed to move
+		if (node == header_.left)
+			header_.left = next_node_(node);
+		if (node == header_.right)
+			header_.right = prev_node_(node);
+		relink_(parent, node, replacement);
+		recount_path_(parent);
+		--size_;
+		// A red node takes over at the same level, nothing else moves
+		if (replacement == NIL && !is_header_(parent))
+			rebalance_after_remove_(parent);
+	}
+
+	// Lowers levels on the way up, until a subtree comes out as high as it was
+	void rebalance_after_remove_(node_ptr_t node)
+	{
+		for (;;)
+		{
+			int        old_level = node->level;
+			node_ptr_t parent    = node->parent;
+
+			update_level_(node);
+			if (node->level == old_level)
+				return ;
+			node_ptr_t top = fixup_after_delete_(node);
+			relink_(parent, node, top);
+			if (is_header_(parent) || top->level == old_level)
+				return ;
+			node = parent;
+		}
+	}
+
+	/*SPLIT & JOIN*/
+
+	// Joins two trees and a node whose key sits between theirs, returns the new root
+	// The lower tree goes down the right spine of the higher one, or the other way
+	// around, to where levels match, pivot takes that place one level up and the
+	// skews and splits of an insertion fix the way back up
+	// O(difference of the root levels), nothing gets compared
+	static node_ptr_t join_(node_ptr_t left, node_ptr_t pivot, node_ptr_t right)
+	{
+		node_ptr_t top;
+
+		if (left->level == right->level)
+		{
+			pivot->left  = left;
+			pivot->right = right;
+			pivot->level = left->level + 1;
+			if (left != NIL)
+				left->parent = pivot;
+			if (right != NIL)
+				right->parent = pivot;
+			recount_(pivot);
+			return pivot;
+		}
+		if (left->level > right->level)
+		{
+			top = left;
+			top->right = join_(left->right, pivot, right);
+			top->right->parent = top;
+		}
+		else
+		{
+			top = right;
+			top->left = join_(left, pivot, right->left);
+			top->left->parent = top;
+		}
+		recount_(top);
+		return split_(skew_(top));
+	}
+
+	// Cuts the tree under node in two, keys less than k under *lower and the others under *upper
+	// Given equal, the node holding k is left out of both and put there, NIL if there is none
+	// Each level joins what it kept with what came back from below, which adds up to O(log n)
+	template <typename K>
+	void split_at_(node_ptr_t node, K const& k, node_ptr_t *lower, node_ptr_t *upper, node_ptr_t *equal = NULL)
+	{
+		if (node == NIL)
+		{
+			*lower = NIL;
+			*upper = NIL;
+			if (equal != NULL)
+				*equal = NIL;
+			return ;
+		}
+
+		node_ptr_t left  = node->left;
+		node_ptr_t right = node->right;
+		node_ptr_t middle;
+		// Without equal, a tie goes up like anything greater and one call tells them apart
+		int        order = equal != NULL ? compare_(node->key(), k) : (compare_func_(node->key(), k) ? -1 : 1);
+
+		if (order < 0)
+		{
+			split_at_(right, k, &middle, upper, equal);
+			*lower = join_(left, node, middle);
+		}
+		else if (equal != NULL && order == 0) // Both sides are already apart
+		{
+			*lower = left;
+			*upper = right;
+			*equal = node;
+		}
+		else
+		{
+			split_at_(left, k, lower, &middle, equal);
+			*upper = join_(middle, node, right);
+		}
+	}
+
+	// Takes the last node out of the tree under node, returns the new root
+	// A standalone tree has no header, so this is the recursive AA deletion
+	static node_ptr_t remove_last_(node_ptr_t node, node_ptr_t *last)
+	{
+		if (node->right == NIL) // Level 1, so no left child either
+		{
+			*last = node;
+			return node->left;
+		}
+		node->right = remove_last_(node->right, last);
+		if (node->right != NIL)
+			node->right->parent = node;
+		recount_(node);
+		update_level_(node);
+		return fixup_after_delete_(node);
+	}
+
+	// join_ for when there is no node in between
+	static node_ptr_t join_trees_(node_ptr_t left, node_ptr_t right)
+	{
+		if (left == NIL)
+			return right;
+		if (right == NIL)
+			return left;
+
+		node_ptr_t pivot;
+		left = remove_last_(left, &pivot);
+		return join_(left, pivot, right);
+	}
+
+	// Destroys and frees every node of a standalone tree, returns how many there were
+	size_type delete_tree_(node_ptr_t node)
+	{
+		if (node == NIL)
+			return 0;
+
+		node_ptr_t right = node->right;
+		size_type  n     = delete_tree_(node->left) + 1;
+
+		delete_node_(node);
+		return n + delete_tree_(right);
+	}
+
+	// Up to this many, a range is erased one node at a time rather than cut out and joined back
+	static size_type const short_range_ = 16;
+
+	// Takes out the elements from lo up to hi, or to the end when hi is NULL
+	// Two splits leave them in a tree of their own, what is left on either side is joined
+	// back, and the whole tree is only rebalanced by that one join
+	size_type erase_between_(Key const& lo, Key const *hi)
+	{
+		node_ptr_t low, rest, middle, high = NIL;
+
+		split_at_(root_, lo, &low, &rest);
+		if (hi == NULL)
+			middle = rest;
+		else
+			split_at_(rest, *hi, &middle, &high);
+		size_type erased = delete_tree_(middle);
+		take_root_(join_trees_(low, high), size_ - erased);
+		return erased;
+	}
+
+	// Makes root, n nodes strong, the whole content of this map
+	void take_root_(node_ptr_t root, size_type n)
+	{
+		root_ = root;
+		size_ = n;
+		adopt_root_();
+		if (root_ != NIL)
+		{
+			header_.left  = leftmost_(root_);
+			header_.right = rightmost_(root_);
+		}
+	}
+
+	// Sizes of two trees holding total nodes between them
+	// Without subtree sizes both are walked side by side until the smaller one runs out
+	static size_type size_of_first_(node_ptr_t first, node_ptr_t second, size_type total)
+	{
+		size_type n;
+
+		if (augment_t::known_size(first, &n))
+			return n;
+		if (first == NIL)
+			return 0;
+		if (second == NIL)
+			return total;
+		first  = leftmost_(first);
+		second = leftmost_(second);
+		for (n = 0; !is_header_(first) && !is_header_(second); ++n)
+		{
+			first  = next_node_(first);
+			second = next_node_(second);
+		}
+		return is_header_(first) ? n : total - n;
+	}
+
+	/*BULK REMOVAL*/
+
+	// Negates a predicate for retain()
+	template <typename Pred>
+	struct rejects_
+	{
+		Pred& pred;
+
+		/*Constructor*/ explicit rejects_(Pred& p) : pred(p) { }
+
+		bool operator()(value_type& v) const { return !pred(v); }
+	};
+
+	// One walk sorts the nodes out without touching the tree, asking pred about every
+	// element once and in order, so a throw leaves the map as it was
+	// If no more than one element in rebuild_ratio matches, the matches are then erased one by
+	// one, otherwise the survivors become a new, perfectly balanced tree in O(n)
+	template <typename Pred>
+	size_type erase_if_(Pred& pred, size_type rebuild_ratio)
+	{
+		std::vector<node_ptr_t> kept;
+		std::vector<node_ptr_t> matches;
+
+		kept.reserve(size_);
+		for (node_ptr_t node = header_.left; !is_header_(node); node = next_node_(node))
+		{
+			if (pred(*iterator(node)))
+				matches.push_back(node);
+			else
+				kept.push_back(node);
+		}
+		if (rebuild_ratio == 0 || matches.size() <= size_ / rebuild_ratio)
+		{
+			for (size_type i = 0; i < matches.size(); ++i)
+				remove_node_(matches[i]);
+		}
+		else
+			rebuild_from_(kept, matches);
+		return matches.size();
+	}
+
+	// Builds a perfectly balanced tree out of n sorted nodes, like build_() does out of a chain
+	node_ptr_t build_from_nodes_(node_ptr_t const *first, size_type n)
+	{
+		if (n == 0)
+			return NIL;
+
+		size_type  left_size = (n - 1) / 2;
+		node_ptr_t node      = first[left_size];
+
+		node->level = level_for_size_(n);
+		node->left  = build_from_nodes_(first, left_size);
+		node->right = build_from_nodes_(first + left_size + 1, n - 1 - left_size);
+		if (node->left != NIL)
+			node->left->parent = node;
+		if (node->right != NIL)
+			node->right->parent = node;
+		recount_(node);
+		return node;
+	}
+
+	// The kept nodes become the whole tree, the dropped ones are freed
+	void rebuild_from_(std::vector<node_ptr_t> const& kept, std::vector<node_ptr_t> const& dropped)
+	{
+		take_root_(kept.empty() ? NIL : build_from_nodes_(&kept[0], kept.size()), kept.size());
+		for (size_type i = 0; i < dropped.size(); ++i)
+			delete_node_(dropped[i]);
+	}
+
+	/*SET OPERATIONS*/
+
+	// Nodes a set operation throws away, chained through their right link
+	// Every thread keeps its own, they are only freed once all of them are done
+	struct discarded_
+	{
+		node_ptr_t chain;
+		size_type  count;
+
+		/*Default Constructor*/ discarded_() : chain(NIL), count(0) { }
+
+		void add(node_ptr_t node)
+		{
+			node->right = chain;
+			chain       = node;
+			++count;
+		}
+
+		void add_tree(node_ptr_t node)
+		{
+			if (node == NIL)
+				return ;
+			node_ptr_t right = node->right;
+			add_tree(node->left);
+			add_tree(right);
+			add(node);
+		}
+
+		void splice(discarded_& other)
+		{
+			if (other.chain == NIL)
+				return ;
+			node_ptr_t last = other.chain;
+			while (last->right != NIL)
+				last = last->right;
+			last->right = chain;
+			chain       = other.chain;
+			count      += other.count;
+		}
+	};
+
+	// How many more times the recursion may fork, and how tall a subtree has to be for it
+	struct parallel_
+	{
+		int forks;
+		int min_level;
+	};
+
+	typedef node_ptr_t (map::*set_op_t)(node_ptr_t, node_ptr_t, discarded_ *, parallel_);
+
+	// Runs op on both pairs of halves, which share no node, the low one on a thread of its own if allowed
+	// Without a thread to be had, or before C++11, both run here one after the other
+	void on_halves_(set_op_t op, node_ptr_t a_low, node_ptr_t b_low, node_ptr_t *low,
+	                node_ptr_t a_high, node_ptr_t b_high, node_ptr_t *high,
+	                discarded_ *discarded, parallel_ parallel)
+	{
+		bool forks = parallel.forks > 0 && std::max(a_low->level, b_low->level) >= parallel.min_level;
+
+		--parallel.forks;
+#if __cplusplus >= 201103L
+		if (forks)
+		{
+			discarded_  low_discarded;
+			std::thread worker;
+
+			try
+			{
+				worker = std::thread([&]() { *low = (this->*op)(a_low, b_low, &low_discarded, parallel); });
+			}
+			catch (std::system_error const&)
+			{
+			}
+			if (worker.joinable())
+			{
+				*high = (this->*op)(a_high, b_high, discarded, parallel);
+				worker.join();
+				discarded->splice(low_discarded);
+				return ;
+			}
+		}
+#else
+		(void)forks;
+#endif
+		*low  = (this->*op)(a_low, b_low, discarded, parallel);
+		*high = (this->*op)(a_high, b_high, discarded, parallel);
+	}
+
+	// The recursions below take two standalone trees and give back the root of the result
+	// b is cut around a's root, so the work is O(m log(n/m + 1)), m <= n the sizes, and where
+	// nothing changes below a node of a, joining back over it is O(1)
+	// On equal keys the element from a is the one kept
+
+	node_ptr_t unite_(node_ptr_t a, node_ptr_t b, discarded_ *discarded, parallel_ parallel)
+	{
+		if (b == NIL)
+			return a;
+		if (a == NIL)
+			return b;
+
+		node_ptr_t b_low, b_high, twin, low, high;
+
+		split_at_(b, a->key(), &b_low, &b_high, &twin);
+		if (twin != NIL)
+			discarded->add(twin);
+		on_halves_(&map::unite_, a->left, b_low, &low, a->right, b_high, &high, discarded, parallel);
+		return join_(low, a, high);
+	}
+
+	node_ptr_t intersect_(node_ptr_t a, node_ptr_t b, discarded_ *discarded, parallel_ parallel)
+	{
+		if (a == NIL || b == NIL)
+		{
+			discarded->add_tree(a);
+			discarded->add_tree(b);
+			return NIL;
+		}
+
+		node_ptr_t b_low, b_high, twin, low, high;
+
+		split_at_(b, a->key(), &b_low, &b_high, &twin);
+		on_halves_(&map::intersect_, a->left, b_low, &low, a->right, b_high, &high, discarded, parallel);
+		if (twin != NIL)
+		{
+			discarded->add(twin);
+			return join_(low, a, high);
+		}
+		discarded->add(a);
+		return join_trees_(low, high);
+	}
+
+	node_ptr_t subtract_(node_ptr_t a, node_ptr_t b, discarded_ *discarded, parallel_ parallel)
+	{
+		if (a == NIL || b == NIL)
+		{
+			discarded->add_tree(b);
+			return a;
+		}
+
+		node_ptr_t b_low, b_high, twin, low, high;
+
+		split_at_(b, a->key(), &b_low, &b_high, &twin);
+		on_halves_(&map::subtract_, a->left, b_low, &low, a->right, b_high, &high, discarded, parallel);
+		if (twin == NIL)
+			return join_(low, a, high);
+		discarded->add(twin);
+		discarded->add(a);
+		return join_trees_(low, high);
+	}
+
+	// Runs op on both trees, the result is left here and source ends up empty
+	// A parallel_cutoff of 0 keeps everything on this thread
+	void set_operation_(set_op_t op, map& source, size_type parallel_cutoff)
+	{
+		size_type  total    = size_ + source.size_;
+		parallel_  parallel = { 0, 0 };
+		discarded_ discarded;
+
+#if __cplusplus >= 201103L
+		if (parallel_cutoff > 0)
+		{
+			// Enough forks for every hardware thread to get a part
+			unsigned threads = std::thread::hardware_concurrency();
+			while ((1u << parallel.forks) < threads)
+				++parallel.forks;
+			parallel.min_level = level_for_size_(parallel_cutoff);
+		}
+#else
+		(void)parallel_cutoff;
+#endif
+		node_pool_.share_with(source.node_pool_); // Our nodes may now come from either map's slabs
+		source.node_pool_.transfer_in_use(node_pool_, source.size_);
+		node_ptr_t root = (this->*op)(root_, source.root_, &discarded, parallel);
+		source.root_ = NIL;
+		source.size_ = 0;
+		source.reset_header_();
+		take_root_(root, total - discarded.count);
+		while (discarded.chain != NIL)
+		{
+			node_ptr_t next = discarded.chain->right;
+			delete_node_(discarded.chain);
+			discarded.chain = next;
+		}
+	}
+
+	/*BULK CONSTRUCTION*/
+
+	// Copies [first, last) into new nodes chained through their right pointer
+	// Later duplicates are dropped on the fly as long as the input is sorted
+	// Their left pointers chain them too, from *newest back, whatever sorting does to the right ones
+	// If a copy or a comparison throws, the nodes made so far are freed
+	template <typename InputIt>
+	node_ptr_t chain_nodes_(InputIt first, InputIt last, size_type *n, bool *sorted, node_ptr_t *newest)
+	{
+		node_ptr_t head = NIL;
+		node_ptr_t tail = NIL;
+
+		*n      = 0;
+		*sorted = true;
+		try
+		{
+			for (; first != last; ++first)
+			{
+				if (tail != NIL && *sorted && !compare_func_(tail->key(), first->first))
+				{
+					if (!compare_func_(first->first, tail->key())) // Same key, keep the first one
+						continue;
+					*sorted = false;
+				}
+				node_ptr_t node = new_node_(first->first, first->second);
+				if (tail == NIL)
+					head = node;
+				else
+					tail->right = node;
+				node->left = tail;
+				tail = node;
+				++*n;
+			}
+		}
+		catch (...)
+		{
+			delete_built_(tail);
+			throw;
+		}
+		*newest = tail;
+		return head;
+	}
+
+	// Frees the nodes chained through left from newest
+	void delete_built_(node_ptr_t newest)
+	{
+		while (newest != NIL)
+		{
+			node_ptr_t older = newest->left;
+			delete_node_(newest);
+			newest = older;
+		}
+	}
+
+	// Merge sort on a chain of n nodes, stable so that the first of equal keys stays first
+	node_ptr_t sort_chain_(node_ptr_t head, size_type n)
+	{
+		if (n < 2)
+			return head;
+
+		node_ptr_t middle = head;
+		for (size_type i = 1; i < n / 2; ++i)
+			middle = middle->right;
+		node_ptr_t second = middle->right;
+		middle->right = NIL;
+
+		node_ptr_t a = sort_chain_(head, n / 2);
+		node_ptr_t b = sort_chain_(second, n - n / 2);
+		node_ptr_t merged = NIL;
+		node_ptr_t *tail  = &merged;
+		while (a != NIL && b != NIL)
+		{
+			if (compare_func_(b->key(), a->key()))
+			{
+				*tail = b;
+				b = b->right;
+			}
+			else
+			{
+				*tail = a;
+				a = a->right;
+			}
+			tail = &(*tail)->right;
+		}
+		*tail = (a != NIL) ? a : b;
+		return merged;
+	}
+
+	// Frees the later ones of equal keys in a sorted chain
+	// Only once every comparison is done, so that a throw leaves all the nodes chained through left
+	node_ptr_t unique_chain_(node_ptr_t head, size_type *n)
+	{
+		node_ptr_t kept    = head;
+		node_ptr_t dropped = NIL;
+
+		while (kept != NIL && kept->right != NIL)
+		{
+			node_ptr_t next = kept->right;
+			if (compare_func_(kept->key(), next->key()))
+				kept = next;
+			else
+			{
+				kept->right = next->right;
+				next->right = dropped;
+				dropped     = next;
+				--*n;
+			}
+		}
+		while (dropped != NIL)
+		{
+			node_ptr_t next = dropped->right;
+			delete_node_(dropped);
+			dropped = next;
+		}
+		return head;
+	}
+
+	// A perfectly balanced subtree of n nodes has its root at level log2(n + 1)
+	static int level_for_size_(size_type n)
+	{
+		int level = 0;
+
+		for (++n; n > 1; n >>= 1)
+			++level;
+		return level;
+	}
+
+	// Builds a perfectly balanced tree out of the next n nodes of a sorted chain
+	// Left halves are never bigger than right ones, so no left link ends up horizontal
+	node_ptr_t build_(node_ptr_t *chain, size_type n)
+	{
+		if (n == 0)
+			return NIL;
+
+		size_type  left_size = (n - 1) / 2;
+		node_ptr_t left      = build_(chain, left_size);
+		node_ptr_t node      = *chain;
+
+		*chain      = node->right;
+		node->level = level_for_size_(n);
+		node->left  = left;
+		node->right = build_(chain, n - 1 - left_size);
+		if (node->left != NIL)
+			node->left->parent = node;
+		if (node->right != NIL)
+			node->right->parent = node;
+		recount_(node);
+		return node;
+	}
+
+	// Replaces the content of an empty tree, O(n) if [first, last) is sorted, O(n log n) otherwise
+	// A throwing copy or comparison frees whatever was built and leaves the tree empty
+	template <typename InputIt>
+	void build_from_(InputIt first, InputIt last)
+	{
+		size_type  n;
+		bool       sorted;
+		node_ptr_t newest;
+		node_ptr_t chain = chain_nodes_(first, last, &n, &sorted, &newest);
+
+		if (!sorted)
+		{
+			try
+			{
+				chain = unique_chain_(sort_chain_(chain, n), &n);
+			}
+			catch (...) // The comparator threw, the right pointers are a mess by now
+			{
+				delete_built_(newest);
+				throw;
+			}
+		}
+		root_ = build_(&chain, n);
+		size_ = n;
+		adopt_root_();
+		if (root_ != NIL)
+		{
+			header_.left  = leftmost_(root_);
+			header_.right = rightmost_(root_);
+		}
+	}
+
+	// Copies the subtree under src into *link, node for node and level for level
+	// Preorder, and each copy is linked in before its children are made, so that
+	// a throwing copy leaves a tree clear() can take down
+	void clone_(node_ptr_t src, node_ptr_t *link, node_ptr_t parent)
+	{
+		node_ptr_t node = new_node_(src->pair.first, src->pair.second);
+
+		node->parent = parent;
+		node->level  = src->level;
+		static_cast<augment_t&>(*node) = static_cast<augment_t const&>(*src); // Same subtree, same summary
+		*link = node;
+		if (src->left != NIL)
+			clone_(src->left, &node->left, node);
+		if (src->right != NIL)
+			clone_(src->right, &node->right, node);
+	}
+
+	// Makes this empty map a copy of other, no comparison and no rebalancing
+	void copy_from_(map const& other)
+	{
+		if (other.root_ == NIL)
+			return ;
+		node_pool_.reserve(other.size_); // A single slab for all of them
+		try
+		{
+			clone_(other.root_, &root_, header_node_());
+		}
+		catch (...)
+		{
+			clear();
+			throw;
+		}
+		take_root_(root_, other.size_);
+	}
+
+	// Slots go back to the pool one by one, they may belong to the slabs of a map we traded nodes with
+	void destroy_nodes_(node_ptr_t node)
+	{
+		if (node == NIL)
+			return ;
+		destroy_nodes_(node->left);
+		destroy_nodes_(node->right);
+		delete_node_(node);
+	}
+
+	// Makes a node that was taken out of some tree look brand new, ready for attach_()
+	static node_ptr_t reset_node_(node_ptr_t node)
+	{
+		node->left  = NIL;
+		node->right = NIL;
+		node->level = 1;
+		node->store(node->key()); // The key may have been changed through a node handle
+		recount_(node);
+		return node;
+	}
+
+	/* NODE HANDLE */
+
+  public:
+	// Owns an element taken out of a map by extract(), node and all, until insert() relinks it
+	// into a map whose allocator compares equal, so moving elements around allocates nothing
+	// The handle's pool gives the node's slot back itself, the map it came from may go away first
+	// Handles only move, before C++11 copying one moves from it too, like std::auto_ptr
+	class node_handle
+	{
+		friend class map;
+
+		/* STATE */
+		mutable node_ptr_t  node_; // NULL when empty
+		mutable node_pool_t pool_;
+
+		/*Constructor*/ node_handle(node_ptr_t node, node_pool_t& from) :
+			node_(node),
+			pool_(from.get_allocator())
+		{
+			pool_.share_with(from);
+			from.transfer_in_use(pool_, 1);
+		}
+
+		void take_(node_handle const& other)
+		{
+			node_       = other.node_;
+			other.node_ = NULL;
+			pool_.swap(other.pool_);
+			other.pool_.release();
+		}
+
+		void reset_()
+		{
+			if (node_ == NULL)
+				return ;
+			node_->~node_t();
+			pool_.deallocate(node_);
+			node_ = NULL;
+		}
+
+	  public:
+		typedef Key   key_type;
+		typedef Value mapped_type;
+		typedef Alloc allocator_type;
+
+		/*Default Constructor*/ node_handle() :
+			node_(NULL),
+			pool_(node_alloc_t())
+		{ }
+
+#if __cplusplus >= 201103L
+		/*Move Constructor*/ node_handle(node_handle&& other) :
+			node_(NULL),
+			pool_(other.pool_.get_allocator())
+		{
+			take_(other);
+		}
+
+		node_handle& operator=(node_handle&& other)
+		{
+			if (this != &other)
+			{
+				reset_();
+				take_(other);
+			}
+			return *this;
+		}
+#else
+		/*Copy Constructor*/ node_handle(node_handle const& other) :
+			node_(NULL),
+			pool_(other.pool_.get_allocator())
+		{
+			take_(other);
+		}
+
+		node_handle& operator=(node_handle const& other)
+		{
+			if (this != &other)
+			{
+				reset_();
+				take_(other);
+			}
+			return *this;
+		}
+#endif
+
+		/*Destructor*/ ~node_handle()
+		{
+			reset_();
+		}
+
+		bool empty() const { return node_ == NULL; }
+		allocator_type get_allocator() const { return allocator_type(pool_.get_allocator()); }
+
+		// The key may be changed while the element is out of any map
+		key_type& key() const { return const_cast<key_type&>(node_->key()); }
+		mapped_type& mapped() const { return node_->value(); }
+
+		void swap(node_handle& other)
+		{
+			std::swap(node_, other.node_);
+			pool_.swap(other.pool_);
+		}
+	};
+
+	// What insert() says about a node handle, node keeps the element when its key was already there
+	struct insert_return_type
+	{
+		iterator  position;
+		bool      inserted;
+		node_type node;
+	};
+
+  protected:
+#if __cplusplus >= 201103L
+	typedef node_type&&      node_type_rvalue_;
+#else
+	typedef node_type const& node_type_rvalue_; // Moved from all the same
+#endif
+
+	// Hands nh's node over to this map at parent, nh is left empty
+	node_ptr_t attach_handle_(node_type const& nh, node_ptr_t parent, bool as_left)
+	{
+		node_ptr_t node = nh.node_;
+
+		node_pool_.share_with(nh.pool_);
+		nh.pool_.transfer_in_use(node_pool_, 1);
+		nh.node_ = NULL;
+		nh.pool_.release();
+		return attach_(reset_node_(node), parent, as_left);
+	}
+
+	/* INTERFACE */
+
+  public:
+	/*Constructor*/ map(Alloc alloc = Alloc()) :
+		root_(NIL),
+		size_(0),
+		node_pool_(node_alloc_t(alloc)) // node_alloc_t and Alloc are different types, conversion thanks to allocator's special ctor
+	{
+		reset_header_();
+	}
+
+	// Builds the tree bottom-up in O(n) when [first, last) is sorted
+	template <typename InputIt>
+	/*Range Constructor*/ map(InputIt first, InputIt last, KeyCmpFn const& comp = KeyCmpFn(), Alloc alloc = Alloc()) :
+		root_(NIL),
+		size_(0),
+		node_pool_(node_alloc_t(alloc)),
+		compare_func_(comp)
+	{
+		reset_header_();
+		build_from_(first, last);
+	}
+
+	// Clones other's tree in one pass, O(n)
+	/*Copy Constructor*/ map(map const& other) :
+		root_(NIL),
+		size_(0),
+		node_pool_(other.node_pool_.get_allocator()),
+		compare_func_(other.compare_func_)
+	{
+		reset_header_();
+		copy_from_(other);
+	}
+
+#if __cplusplus >= 201103L
+	// Takes other's nodes as they are, leaving it empty
+	/*Move Constructor*/ map(map&& other) :
+		root_(NIL),
+		size_(0),
+		node_pool_(other.node_pool_.get_allocator()),
+		compare_func_(other.compare_func_)
+	{
+		reset_header_();
+		swap(other);
+	}
+#endif
+
+	/*Destructor*/ ~map()
+	{
+		this->clear();
+	}
+
+	// The copy is made before anything is let go of, so a throw leaves this map as it was
+	map& operator=(map const& rhs)
+	{
+		if (this != &rhs)
+		{
+			map copy(rhs);
+			swap(copy);
+		}
+		return *this;
+	}
+
+#if __cplusplus >= 201103L
+	map& operator=(map&& rhs)
+	{
+		if (this != &rhs)
+		{
+			this->clear();
+			swap(rhs);
+		}
+		return *this;
+	}
+
+	mapped_type& operator[]( Key&& key )
+	{
+		return try_emplace(std::move(key)).first->second;
+	}
+#endif
+
+	// A single descent, the value is only made when key is not there yet
+	mapped_type& operator[]( const Key& key )
+	{
+		// Using operator[] requires that the mapped type be default constructible
+		// If that is not the case use this->at() or in C++11 this->emplace()
+#if __cplusplus >= 201103L
+		return try_emplace(key).first->second;
+#else
+		node_ptr_t parent  = NIL;
+		bool       as_left = false;
+		node_ptr_t found = insert_position_(key, &parent, &as_left);
+
+		if (found != NIL)
+			return found->value();
+		return attach_(new_node_(key, mapped_type()), parent, as_left)->value();
+#endif
+	}
+
+	// The value for key, made out of what factory() returns if key is not there yet
+	// Same single descent as operator[], and factory is only called for a new element
+	template <typename Factory>
+	mapped_type& get_or_insert( const Key& key, Factory factory )
+	{
+		node_ptr_t parent  = NIL;
+		bool       as_left = false;
+		node_ptr_t found = insert_position_(key, &parent, &as_left);
+
+		if (found != NIL)
+			return found->value();
+		return attach_(new_node_(key, factory()), parent, as_left)->value();
+	}
+
+	// MODIFIERS
+
+	// Every slot is given back to the pool, which lets go of the slabs no other map holds nodes of
+	void clear()
+	{
+		destroy_nodes_(root_);
+		node_pool_.release();
+		root_ = NIL;
+		size_ = 0;
+		reset_header_();
+	}
+
+	// Preallocates room for n more elements so that inserting them won't hit the allocator
+	void reserve(size_type n)
+	{
+		node_pool_.reserve(n);
+	}
+
+	ft::pair<iterator, bool> insert(pair_type_t const& pair)
+	{
+		size_type size_before = size_;
+		iterator it = insert_(pair.first, pair.second);
+
+		if (size_before == size_)
+			return ft::make_pair(it, false);
+		else
+			return ft::make_pair(it, true);
+	}
+
+#if __cplusplus >= 201103L
+	// The element is built inside its node, which is thrown away if the key is already there
+	template <typename... Args>
+	ft::pair<iterator, bool> emplace(Args&&... args)
+	{
+		node_ptr_t node = new_node_(std::forward<Args>(args)...);
+		node_ptr_t parent  = NIL;
+		bool       as_left = false;
+		node_ptr_t found = insert_position_(node->key(), &parent, &as_left);
+
+		if (found != NIL)
+		{
+			delete_node_(node);
+			return ft::make_pair(iterator(found), false);
+		}
+		return ft::make_pair(iterator(attach_(node, parent, as_left)), true);
+	}
+
+	// Unlike emplace, nothing is built nor moved from when k is already there
+	template <typename... Args>
+	ft::pair<iterator, bool> try_emplace(Key const& k, Args&&... args)
+	{
+		node_ptr_t parent  = NIL;
+		bool       as_left = false;
+		node_ptr_t found = insert_position_(k, &parent, &as_left);
+
+		if (found != NIL)
+			return ft::make_pair(iterator(found), false);
+		node_ptr_t node = new_node_(std::piecewise_construct, std::forward_as_tuple(k),
+		                            std::forward_as_tuple(std::forward<Args>(args)...));
+		return ft::make_pair(iterator(attach_(node, parent, as_left)), true);
+	}
+
+	template <typename... Args>
+	ft::pair<iterator, bool> try_emplace(Key&& k, Args&&... args)
+	{
+		node_ptr_t parent  = NIL;
+		bool       as_left = false;
+		node_ptr_t found = insert_position_(k, &parent, &as_left);
+
+		if (found != NIL)
+			return ft::make_pair(iterator(found), false);
+		node_ptr_t node = new_node_(std::piecewise_construct, std::forward_as_tuple(std::move(k)),
+		                            std::forward_as_tuple(std::forward<Args>(args)...));
+		return ft::make_pair(iterator(attach_(node, parent, as_left)), true);
+	}
+
+	template <typename M>
+	ft::pair<iterator, bool> insert_or_assign(Key const& k, M&& obj)
+	{
+		node_ptr_t parent  = NIL;
+		bool       as_left = false;
+		node_ptr_t found = insert_position_(k, &parent, &as_left);
+
+		if (found != NIL)
+		{
+			found->value() = std::forward<M>(obj);
+			recount_path_(found);
+			return ft::make_pair(iterator(found), false);
+		}
+		return ft::make_pair(iterator(attach_(new_node_(k, std::forward<M>(obj)), parent, as_left)), true);
+	}
+
+	template <typename M>
+	ft::pair<iterator, bool> insert_or_assign(Key&& k, M&& obj)
+	{
+		node_ptr_t parent  = NIL;
+		bool       as_left = false;
+		node_ptr_t found = insert_position_(k, &parent, &as_left);
+
+		if (found != NIL)
+		{
+			found->value() = std::forward<M>(obj);
+			recount_path_(found);
+			return ft::make_pair(iterator(found), false);
+		}
+		return ft::make_pair(iterator(attach_(new_node_(std::move(k), std::forward<M>(obj)), parent, as_left)), true);
+	}
+#endif
+
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last)
+	{
+		if (root_ == NIL)
+			return build_from_(first, last);
+		// Each insertion hints at the previous one, runs of sorted keys are cheap
+		iterator hint = this->end();
+		for (; first != last; ++first)
+			hint = insert_(hint.current_, first->first, first->second);
+	}
+
+	// insert(first, last) for elements sorted by key that land anywhere in the map
+	// Each one is placed by a finger search from where the previous one went, which makes it
+	// one pass over the tree, O(m log(n/m + 1)) for m elements, unsorted input still ends up right
+	template <typename InputIt>
+	void insert_sorted_batch(InputIt first, InputIt last)
+	{
+		node_ptr_t finger = header_.left;
+
+		for (; first != last; ++first)
+		{
+			node_ptr_t next = lower_bound_from_node_(finger, first->first);
+
+			if (!is_header_(next) && !compare_func_(first->first, next->key())) // Already there
+				finger = next;
+			else
+				finger = attach_before_(new_node_(first->first, first->second), next);
+		}
+	}
+
+	// Replaces the content with [first, last), linear time if it is sorted
+	// Unsorted input is sorted first, the first of equal keys wins
+	template <typename InputIt>
+	void assign_sorted(InputIt first, InputIt last)
+	{
+		this->clear();
+		build_from_(first, last);
+	}
+
+	// Amortized O(1) when new_val belongs right before or right after hint
+	iterator insert(iterator hint, pair_type_t const &new_val)
+	{
+		return insert_(hint.current_, new_val.first, new_val.second);
+	}
+
+	size_type erase(Key const& k)
+	{
+		node_ptr_t node = find_node_(k);
+
+		if (is_header_(node))
+			return 0;
+		remove_node_(node);
+		return 1;
+	}
+
+	void erase( iterator it )
+	{
+		remove_node_(it.current_);
+	}
+
+	// Iterators to the other elements stay valid
+	// The first few go one at a time, a range that turns out longer has the rest cut out of the
+	// tree and freed in one pass, O(log n) plus its k nodes instead of a search and a rebalance each
+	void erase( iterator first, iterator last )
+	{
+		node_ptr_t node = first.current_;
+
+		for (size_type n = 0; node != last.current_; ++n)
+		{
+			if (n == short_range_)
+			{
+				erase_between_(node->key(), is_header_(last.current_) ? NULL : &last.current_->key());
+				return ;
+			}
+			node_ptr_t next = next_node_(node);
+			remove_node_(node);
+			node = next;
 		}
 	}
 
-	mapped_type& operator[]( const Key& key )
+	// Erases the elements whose key is not less than lo and less than hi, returns how many there were
+	// Same as erasing by iterators, without looking both of them up
+	size_type erase_range( const Key& lo, const Key& hi )
 	{
-		// Using operator[] requires that the mapped type be default constructible
-		// If that is not the case use this->at() or in C++11 this->emplace()
-		iterator it = lower_bound(key); // (*it).first is *not less* than key
-		if ( it == this->end() || compare_func_(key, (*it).first) ) // if (*i).first is greater than key i.e key does not exist
-			it = insert(it, pair_type_t(key, mapped_type())); // Insert default value with that key
-		return (*it).second;
-	}
+		if (!compare_func_(lo, hi))
+			return 0;
 
-	// MODIFIERS
+		node_ptr_t node = lower_bound(lo).current_;
+		size_type  n    = 0;
 
-	void clear()
+		for (; !is_header_(node) && compare_func_(node->key(), hi); ++n)
+		{
+			if (n == short_range_)
+				return n + erase_between_(node->key(), &hi);
+			node_ptr_t next = next_node_(node);
+			remove_node_(node);
+			node = next;
+		}
+		return n;
+	}
+
+	// Erases every element pred holds true for, returns how many there were
+	// pred sees each element once and in order, iterators to the others stay valid
+	// Past one match in rebuild_ratio, the survivors are relinked into a new balanced tree
+	// in one O(n) pass rather than erased around one by one, 0 never rebuilds
+	// Sorting them out takes a pointer per element of scratch memory
+	template <typename Pred>
+	size_type erase_if( Pred pred, size_type rebuild_ratio = 4 )
 	{
-		root_ = clear_(root_);
+		return erase_if_(pred, rebuild_ratio);
 	}
 
-	ft::pair<iterator, bool> insert(pair_type_t const& pair)
+	// The other way around, keeps only the elements pred holds true for
+	template <typename Pred>
+	size_type retain( Pred pred, size_type rebuild_ratio = 4 )
 	{
-		size_type size_before = size_;
-		iterator it = insert_(pair.first, pair.second);
+		rejects_<Pred> rejects(pred);
 
-		if (size_before == size_)
-			return ft::make_pair(it, false);
-		else
-			return ft::make_pair(it, true);
+		return erase_if_(rejects, rebuild_ratio);
 	}
 
-	void insert(iterator first, iterator last)
+	// Takes the element out without destroying it, other iterators stay valid
+	node_type extract( iterator position )
 	{
-		for (; first != last; ++first)
-			insert(*first);
+		unlink_node_(position.current_);
+		return node_type(position.current_, node_pool_);
 	}
 
-	iterator insert(iterator hint, pair_type_t const &new_val)
+	// An empty handle if k is not there
+	node_type extract( Key const& k )
 	{
-		(void)hint;
-		return insert(new_val).first;
+		node_ptr_t node = find_node_(k);
+
+		if (is_header_(node))
+			return node_type();
+		return extract(iterator(node));
 	}
 
-	size_type erase(Key const& k)
+	// Relinks the handle's node, unless its key is already there, in which case nh keeps it
+	// Iterators to the element stay valid once it is in, nothing is allocated nor copied
+	insert_return_type insert( node_type_rvalue_ nh )
 	{
-		size_type size_before = size_;
-		root_ = remove_(k, root_);
-		if (size_before == size_)
-			return 0;
-		return 0;
+		insert_return_type ret;
+
+		ret.inserted = false;
+		ret.position = end();
+		if (nh.empty())
+			return ret;
+
+		node_ptr_t parent  = NIL;
+		bool       as_left = false;
+		node_ptr_t found = insert_position_(nh.key(), &parent, &as_left);
+
+		if (found != NIL)
+		{
+			ret.position = iterator(found);
+			ret.node.take_(nh);
+			return ret;
+		}
+		ret.position = iterator(attach_handle_(nh, parent, as_left));
+		ret.inserted = true;
+		return ret;
 	}
 
-	void erase( iterator it )
+	// Same as insert(nh) when the key is already there, nh then keeps the node
+	iterator insert( iterator hint, node_type_rvalue_ nh )
 	{
-		erase(*it->key());
+		if (nh.empty())
+			return end();
+
+		node_ptr_t parent  = NIL;
+		bool       as_left = false;
+		node_ptr_t found = hint_position_(hint.current_, nh.key(), &parent, &as_left);
+
+		if (found != NIL)
+			return iterator(found);
+		return iterator(attach_handle_(nh, parent, as_left));
 	}
 
-	void erase( iterator first, iterator last )
+	// Relinks every element of source whose key is not here yet, the others stay in source
+	// Nodes never get copied, iterators to moved elements now point into this map
+	// Source is walked in order, each key hinting at where the next one goes
+	void merge( map& source )
 	{
-		for (; first != last ; ++first)
-			erase(first);
+		if (&source == this || source.root_ == NIL)
+			return ;
+
+		size_type  moved = 0;
+		node_ptr_t hint  = header_node_();
+		node_ptr_t node  = source.header_.left;
+
+		node_pool_.share_with(source.node_pool_);
+		while (!is_header_(node))
+		{
+			node_ptr_t next = next_node_(node); // Unlinking only trades links, next stays next
+			node_ptr_t parent  = NIL;
+			bool       as_left = false;
+			node_ptr_t found = hint_position_(hint, node->key(), &parent, &as_left);
+
+			if (found == NIL)
+			{
+				source.unlink_node_(node);
+				attach_(reset_node_(node), parent, as_left);
+				++moved;
+				found = node;
+			}
+			hint = next_node_(found);
+			node = next;
+		}
+		source.node_pool_.transfer_in_use(node_pool_, moved);
 	}
 
 	void swap( map& other )
@@ -426,9 +2046,96 @@ class map
 
 			other.root_ = tmp_root;
 			other.size_ = tmp_size;
+			std::swap(header_.left, other.header_.left);
+			std::swap(header_.right, other.header_.right);
+			adopt_root_();
+			other.adopt_root_();
+			node_pool_.swap(other.node_pool_); // Nodes belong to the pool they came from
+			std::swap(compare_func_, other.compare_func_);
 		}
 	}
 
+	// Moves every element whose key is not less than key into upper, which loses what it held
+	// Nodes are relinked, not copied, and iterators stay valid, in the map their element went to
+	// O(log n) to cut, plus O(min of the two sizes) to count them unless Augment counts subtrees
+	void split( const Key& key, map& upper )
+	{
+		if (&upper == this)
+			return ;
+		upper.clear();
+
+		node_ptr_t lower_root;
+		node_ptr_t upper_root;
+		size_type  total = size_;
+
+		split_at_(root_, key, &lower_root, &upper_root);
+		take_root_(lower_root, 0);
+		upper.take_root_(upper_root, 0);
+		size_       = size_of_first_(lower_root, upper_root, total);
+		upper.size_ = total - size_;
+		upper.compare_func_ = compare_func_;
+		node_pool_.share_with(upper.node_pool_); // Both maps now hold nodes from our slabs
+		node_pool_.transfer_in_use(upper.node_pool_, upper.size_);
+	}
+
+	// Moves every element of other in, other's keys must all be greater than ours or all less
+	// Throws std::invalid_argument if the ranges overlap, leaving both maps as they were
+	// Nodes are relinked, not copied, and iterators stay valid, O(log n)
+	void join( map& other )
+	{
+		if (&other == this || other.root_ == NIL)
+			return ;
+
+		map *low  = this;
+		map *high = &other;
+		if (root_ != NIL && compare_func_(other.header_.right->key(), header_.left->key()))
+			std::swap(low, high);
+		else if (root_ != NIL && !compare_func_(header_.right->key(), other.header_.left->key()))
+			throw std::invalid_argument("map::join: key ranges overlap");
+
+		size_type  moved = other.size_;
+		size_type  total = size_ + other.size_;
+		node_ptr_t pivot = high->header_.left; // Any node between the two trees will do
+
+		high->unlink_node_(pivot);
+		node_ptr_t root = join_(low->root_, pivot, high->root_);
+		other.root_ = NIL;
+		other.size_ = 0;
+		other.reset_header_();
+		take_root_(root, total);
+		node_pool_.share_with(other.node_pool_);
+		other.node_pool_.transfer_in_use(node_pool_, moved);
+	}
+
+	// In-place set operations, source is emptied and its nodes are relinked here, not copied
+	// Where both maps hold a key, the element already here is kept and source's is destroyed
+	// O(m log(n/m + 1)) comparisons, m <= n the two sizes, instead of O(m log n) for inserting one by one
+	// From C++11 on, a parallel_cutoff above 0 runs the two halves of each subtree at least that big
+	// on a thread of their own, as long as there are hardware threads left, KeyCmpFn must not throw then
+
+	// Every element of either map
+	void unite( map& source, size_type parallel_cutoff = 0 )
+	{
+		if (&source != this)
+			set_operation_(&map::unite_, source, parallel_cutoff);
+	}
+
+	// The elements whose key is in both maps
+	void intersect( map& source, size_type parallel_cutoff = 0 )
+	{
+		if (&source != this)
+			set_operation_(&map::intersect_, source, parallel_cutoff);
+	}
+
+	// The elements whose key is not in source
+	void subtract( map& source, size_type parallel_cutoff = 0 )
+	{
+		if (&source == this)
+			clear();
+		else
+			set_operation_(&map::subtract_, source, parallel_cutoff);
+	}
+
 	/* CAPACITY */
 
 	bool empty() const
@@ -446,7 +2153,7 @@ class map
 
 	size_type max_size() const
 	{
-		return node_alloc_.max_size();
+		return node_pool_.max_size();
 	}
 
 	/* LOOKUP */
@@ -460,44 +2167,27 @@ class map
 
 	iterator find( const Key& key )
 	{
-		node_ptr_t current;
-		bool searched_is_strictly_less;
-		bool searched_is_strictly_greater;
-
-		current = root_;
-		while (current != NIL)
-		{
-			searched_is_strictly_less = compare_func_(key, current->key());
-			searched_is_strictly_greater = compare_func_(current->key, key);
-			if (searched_is_strictly_less)
-				current = current->_left;
-			else if (searched_is_strictly_greater)
-				current = current->_right;
-			else // they're equal
-				return iterator(root_, current);
-		}
-		return this->end();
+		return iterator(find_node_(key));
 	}
 
 	const_iterator find( const Key& key ) const
 	{
-		node_ptr_t current;
-		bool searched_is_strictly_less;
-		bool searched_is_strictly_greater; 
+		return const_iterator(find_node_(key));
+	}
 
-		current = root_;
-		while (current != NIL)
-		{
-			searched_is_strictly_less = compare_func_(key, current->key());
-			searched_is_strictly_greater = compare_func_(current->key, key);
-			if (searched_is_strictly_less)
-				current = current->_left;
-			else if (searched_is_strictly_greater)
-				current = current->_right;
-			else // they're equal
-				return const_iterator(root_, current);
-		}
-		return this->end();
+	// Writes find(k) for every k of [first, last) to out, in order, and returns where out ended up
+	// Interleaving the lookups hides most of the memory latency of a big tree, see find_batch_()
+	// KeyIt must be a forward iterator, keys are read more than once
+	template <typename KeyIt, typename OutIt>
+	OutIt find_batch( KeyIt first, KeyIt last, OutIt out )
+	{
+		return find_batch_<iterator>(first, last, out);
+	}
+
+	template <typename KeyIt, typename OutIt>
+	OutIt find_batch( KeyIt first, KeyIt last, OutIt out ) const
+	{
+		return find_batch_<const_iterator>(first, last, out);
 	}
 
 	ft::pair<iterator,iterator> equal_range( const Key& key )
@@ -513,131 +2203,300 @@ class map
 	/* Returns lower bound not less than key */
 	iterator lower_bound( const Key& key )
 	{
-		bool searched_is_strictly_less;  
-		bool searched_is_strictly_greater; 
-		node_ptr_t current;
-		node_ptr_t parent;
+		return iterator(lower_bound_node_(key));
+	}
 
-		if (root_ == NIL) // Empty tree
-			return this->end();
-		parent = NULL;
-		current = root_;
-		while (current != NIL)
+	/* Returns lower bound not less than key */
+	const_iterator lower_bound( const Key& key ) const
+	{
+		return const_iterator(lower_bound_node_(key));
+	}
+
+	/* Returns iterator to the first element greater than key */
+	iterator upper_bound( const Key& key )
+	{
+		return iterator(upper_bound_node_(key));
+	}
+
+	/* Returns iterator to the first element greater than key */
+	const_iterator upper_bound( const Key& key ) const
+	{
+		return const_iterator(upper_bound_node_(key));
+	}
+
+	/* Finger search, starting from an iterator close to the answer instead of the root */
+	/* Any finger gives the right answer, a close one gives it in about O(log distance) */
+
+	iterator lower_bound_from( iterator finger, const Key& key )
+	{
+		return iterator(lower_bound_from_node_(finger.current_, key));
+	}
+
+	const_iterator lower_bound_from( const_iterator finger, const Key& key ) const
+	{
+		return const_iterator(lower_bound_from_node_(finger.current_, key));
+	}
+
+	iterator find_from( iterator finger, const Key& key )
+	{
+		return iterator(find_from_node_(finger.current_, key));
+	}
+
+	const_iterator find_from( const_iterator finger, const Key& key ) const
+	{
+		return const_iterator(find_from_node_(finger.current_, key));
+	}
+
+	// find() for every key of [first, last) into out, each lookup starting from the previous answer
+	// Sorted keys make it one pass over the tree, O(m log(n/m + 1)), unsorted ones still work
+	template <typename KeyIt, typename OutIt>
+	OutIt find_sorted_batch( KeyIt first, KeyIt last, OutIt out )
+	{
+		node_ptr_t finger = header_.left;
+
+		for (; first != last; ++first)
 		{
-			searched_is_strictly_less = compare_func_(key, current->key());
-			searched_is_strictly_greater = compare_func_(current->key(), key);
-			
-			parent = current;
-			if (searched_is_strictly_less) // than current's key
-				current = current->left;
-			else if (searched_is_strictly_greater) // than current's key
-				current = current->right;
-			else // searched and current kes are equal
-				return iterator(root_, current);
+			finger = lower_bound_from_node_(finger, *first);
+			*out++ = iterator(is_header_(finger) || compare_func_(*first, finger->key()) ? header_node_() : finger);
 		}
-		return ++iterator(root_, parent);
+		return out;
 	}
 
-	/* Returns lower bound not less than key */
-	const_iterator lower_bound( const Key& key ) const
+	template <typename KeyIt, typename OutIt>
+	OutIt find_sorted_batch( KeyIt first, KeyIt last, OutIt out ) const
 	{
-		bool searched_is_strictly_less;  
-		bool searched_is_strictly_greater; 
-		node_ptr_t current;
-		node_ptr_t parent;
+		node_ptr_t finger = header_.left;
 
-		if (root_ == NIL) // Empty tree
-			return this->end();
-		parent = NULL;
-		current = root_;
-		while (current != NIL)
+		for (; first != last; ++first)
 		{
-			searched_is_strictly_less = compare_func_(key, current->key());
-			searched_is_strictly_greater = compare_func_(current->key(), key);
-			
-			parent = current;
-			if (searched_is_strictly_less) // than current's key
-				current = current->left;
-			else if (searched_is_strictly_greater) // than current's key
-				current = current->right;
-			else // searched and current kes are equal
-				return iterator(root_, current);
+			finger = lower_bound_from_node_(finger, *first);
+			*out++ = const_iterator(is_header_(finger) || compare_func_(*first, finger->key()) ? header_node_() : finger);
 		}
-		return ++iterator(root_, parent);
+		return out;
 	}
 
+	/* Heterogeneous lookup, only there if KeyCmpFn has an is_transparent member type */
+	/* The key is compared as is, so no Key gets built out of it */
 
-	/* Returns iterator to the first element greater than key */
-	iterator upper_bound( const Key& key )
+	template <typename K>
+	typename if_transparent_<K, size_type>::type count( const K& key ) const
+	{
+		if (is_header_(find_node_(key)))
+			return 0;
+		return 1;
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type find( const K& key )
+	{
+		return iterator(find_node_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type find( const K& key ) const
+	{
+		return const_iterator(find_node_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, ft::pair<iterator,iterator> >::type equal_range( const K& key )
+	{
+		return ft::make_pair(iterator(lower_bound_node_(key)), iterator(upper_bound_node_(key)));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, ft::pair<const_iterator,const_iterator> >::type equal_range( const K& key ) const
+	{
+		return ft::make_pair(const_iterator(lower_bound_node_(key)), const_iterator(upper_bound_node_(key)));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type lower_bound( const K& key )
+	{
+		return iterator(lower_bound_node_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type lower_bound( const K& key ) const
+	{
+		return const_iterator(lower_bound_node_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, iterator>::type upper_bound( const K& key )
+	{
+		return iterator(upper_bound_node_(key));
+	}
+
+	template <typename K>
+	typename if_transparent_<K, const_iterator>::type upper_bound( const K& key ) const
+	{
+		return const_iterator(upper_bound_node_(key));
+	}
+
+	/* ORDER STATISTICS */
+	/* O(log n), only compile when Augment counts subtrees */
+
+	// How many keys are less than key, which is also the index of lower_bound(key)
+	size_type rank( const Key& key ) const
 	{
-		bool searched_is_strictly_less;  
-		bool searched_is_strictly_greater; 
-		node_ptr_t current;
-		node_ptr_t best_predecessor;
+		node_ptr_t current = root_;
+		size_type  below   = 0;
 
-		if (root_ == NIL) // Empty tree
-			return this->end();
-		best_predecessor = NULL;
-		current = root_;
 		while (current != NIL)
 		{
-			searched_is_strictly_less = compare_func_(key, current->key());
-			searched_is_strictly_greater = compare_func_(current->key, key);
-			
-			if (searched_is_strictly_less) // than current's key
+			if (compare_func_(current->key(), key)) // current and its left subtree are all less
 			{
-				current = current->left;
-				best_predecessor = current;
+				below  += current->left->subtree_size + 1;
+				current = current->right;
 			}
-			else if (searched_is_strictly_greater) // than current's key
+			else
+				current = current->left;
+		}
+		return below;
+	}
+
+	// The element at index i in key order, end() past the last one
+	iterator select( size_type i )
+	{
+		return iterator(select_node_(i));
+	}
+
+	const_iterator select( size_type i ) const
+	{
+		return const_iterator(select_node_(i));
+	}
+
+	// How many keys lie in [lo, hi)
+	size_type count_range( const Key& lo, const Key& hi ) const
+	{
+		if (!compare_func_(lo, hi))
+			return 0;
+		return rank(hi) - rank(lo);
+	}
+
+	// Index of the element it points to, size() for end()
+	size_type index_of( const_iterator it ) const
+	{
+		node_ptr_t node = it.current_;
+
+		if (is_header_(node))
+			return size_;
+
+		size_type index = node->left->subtree_size;
+		for (; !is_header_(node->parent); node = node->parent)
+			if (node == node->parent->right) // The parent and its left subtree come first
+				index += node->parent->left->subtree_size + 1;
+		return index;
+	}
+
+	// Same as std::distance(first, last) without walking from one to the other
+	difference_type distance( const_iterator first, const_iterator last ) const
+	{
+		return static_cast<difference_type>(index_of(last)) - static_cast<difference_type>(index_of(first));
+	}
+
+	/* AGGREGATES */
+	/* Only compile when Augment is an ft::aggregate */
+
+	// The Monoid's combination of every value, in key order
+	aggregate_type aggregate() const
+	{
+		return root_->subtree_aggregate;
+	}
+
+	// Same over the keys in [lo, hi), O(log n) whatever the number of keys in there
+	aggregate_type aggregate( const Key& lo, const Key& hi ) const
+	{
+		typedef typename Augment::monoid_type monoid;
+
+		node_ptr_t top = root_;
+
+		// Down to the first node inside the range, every other one in it is below
+		while (top != NIL)
+		{
+			if (compare_func_(top->key(), lo))
+				top = top->right;
+			else if (!compare_func_(top->key(), hi))
+				top = top->left;
+			else
+				break;
+		}
+		if (top == NIL)
+			return monoid::identity();
+
+		// Left of top, every node not less than lo comes in with its whole right subtree
+		aggregate_type below = monoid::identity();
+		for (node_ptr_t node = top->left; node != NIL; )
+		{
+			if (compare_func_(node->key(), lo))
+				node = node->right;
+			else
 			{
-				current = current->right;
-				best_predecessor = current;
+				aggregate_type here = monoid::combine(aggregate_type(node->value()), node->right->subtree_aggregate);
+				below = monoid::combine(here, below);
+				node  = node->left;
 			}
+		}
+
+		// Right of top, every node less than hi comes in with its whole left subtree
+		aggregate_type above = monoid::identity();
+		for (node_ptr_t node = top->right; node != NIL; )
+		{
+			if (!compare_func_(node->key(), hi))
+				node = node->left;
 			else
-				best_predecessor = current;
+			{
+				aggregate_type here = monoid::combine(node->left->subtree_aggregate, aggregate_type(node->value()));
+				above = monoid::combine(above, here);
+				node  = node->right;
+			}
 		}
-		return ++iterator(root_, best_predecessor);
+		return monoid::combine(monoid::combine(below, aggregate_type(top->value())), above);
 	}
 
-	/* Returns iterator to the first element greater than key */
-	const_iterator upper_bound( const Key& key ) const
+	// Writes through operator[], an iterator or any other reference to a value are not seen by the map
+	// aggregate() gives stale answers until they are reported here, O(log n)
+	void refresh( iterator it )
+	{
+		recount_path_(it.current_);
+	}
+
+	// Writes the value and updates the aggregates above it in one go
+	void set_value( iterator it, Value const& value )
+	{
+		it.current_->value() = value;
+		recount_path_(it.current_);
+	}
+
+  protected:
+	node_ptr_t select_node_( size_type i ) const
 	{
-		bool searched_is_strictly_less;  
-		bool searched_is_strictly_greater; 
-		node_ptr_t current;
-		node_ptr_t best_predecessor;
+		node_ptr_t current = root_;
 
-		if (root_ == NIL) // Empty tree
-			return this->end();
-		best_predecessor = NULL;
-		current = root_;
 		while (current != NIL)
 		{
-			searched_is_strictly_less = compare_func_(key, current->key());
-			searched_is_strictly_greater = compare_func_(current->key, key);
-			
-			if (searched_is_strictly_less) // than current's key
-			{
+			size_type left_size = current->left->subtree_size;
+
+			if (i < left_size)
 				current = current->left;
-				best_predecessor = current;
-			}
-			else if (searched_is_strictly_greater) // than current's key
+			else if (i == left_size)
+				return current;
+			else
 			{
+				i      -= left_size + 1;
 				current = current->right;
-				best_predecessor = current;
 			}
-			else
-				best_predecessor = current;
 		}
-		return ++iterator(root_, best_predecessor);
+		return header_node_();
 	}
 
+  public:
 	/* OBSERVERS */
 
 	allocator_type get_allocator() const
 	{
-		return allocator_type(node_alloc_); // Implicit conversion
+		return allocator_type(node_pool_.get_allocator()); // Implicit conversion
 	}
 
 	key_compare key_comp() const
@@ -648,114 +2507,88 @@ class map
 	/* NESTED ITERATOR CLASSES */
 
   protected:
+	// What iterators over MaybeConstValue refer to, const for const_iterator
+	template <typename MaybeConstValue>
+	struct element_
+	{
+		typedef value_type type;
+	};
+
+	template <typename MaybeConstValue>
+	struct element_<MaybeConstValue const>
+	{
+		typedef value_type const type;
+	};
+
 	template <typename MaybeConstValue>
 	class aat_iterator
 	{
 	  public:
-		typedef typename
-		map<const Key, MaybeConstValue, KeyCmpFn, Alloc>::value_type value_type;
-		typedef value_type&                                           reference;
-		typedef value_type*                                             pointer;
+		typedef ft::pair<const Key, Value>                           value_type;
+		typedef typename element_<MaybeConstValue>::type&             reference;
+		typedef typename element_<MaybeConstValue>::type*               pointer;
 		typedef bidirectional_iterator_tag                    iterator_category;
 		typedef std::ptrdiff_t                                  difference_type;
 	  protected:
 		typedef
-		map<Key, Value, KeyCmpFn, Alloc>::node_ptr_t         node_ptr_t;
+		map<Key, Value, KeyCmpFn, Alloc, Augment>::node_ptr_t node_ptr_t;
+
+		friend class map; // So that it can get to the node behind an iterator
 
 		/* STATE */
-		node_ptr_t             root_;
-		node_ptr_t             current_;
+		node_ptr_t             current_; // The header for end()
 
 	  public:
 
-		/* Constructor */ aat_iterator(node_ptr_t root, node_ptr_t current)
-			: root_(root), current_(current)
+		/* Default Constructor */ aat_iterator()
+			: current_(NULL)
 		{ }
 
-		/* Copy Constructor */ aat_iterator(aat_iterator const &other)
-			: root_(other.root_), current_(other.current_)
+		/* Constructor */ explicit aat_iterator(node_ptr_t current)
+			: current_(current)
 		{ }
 
-		/* Conversion */ operator map<Key, Value, KeyCmpFn, Alloc>::const_iterator()
+		/* Conversion */ operator map<Key, Value, KeyCmpFn, Alloc, Augment>::const_iterator() const
 		{
-			return map<Key, Value, KeyCmpFn, Alloc>::const_iterator(root_, current_);
+			return map<Key, Value, KeyCmpFn, Alloc, Augment>::const_iterator(current_);
 		}
 
-		aat_iterator &operator=(iterator const &rhs)
-		{
-			root_ = rhs.root_;
-			current_ = rhs.current_;
-			return *this;
-		}
 		pointer operator->() const { return &(this->operator*()); }
 
-		reference operator*() const { return reinterpret_cast<reference>(current_->pair); }
-		//reference operator*() const { return current_->pair; }
+		reference operator*() const { return current_->pair; }
 
 		bool operator==(aat_iterator const &rhs) const { return current_ == rhs.current_; }
 
 		bool operator!=(aat_iterator const &rhs) const { return current_ != rhs.current_; }
 
-		// iterator will cycle forward passing through an end's marker
+		// iterator will cycle forward passing through the end marker
 		aat_iterator &operator++()
 		{
-			root_ = update_root(root_);
-			if (root_ == NIL) // Tree empty ?
-				current_ = NULL;
-			else if (current_ == NULL) 
-				current_ = leftmost_(root_);
-			// If tree was empty but stuff got in since last call
-			 // If has successor...
-			else if (current_->right != NIL)
-				current_ = leftmost_(current_->right); // ... goes to successor
-			// Else if it has no successor under itself
-			else if (current_ == current_->parent->left) // If it is its parent's left child
-				current_ = current_->parent; // ... it becomes its parent
-			// Then it's its parent's right child
-			else 
-			{
-				while (current_ == current_->parent->right) // Go up the succession of right children
-					current_ = current_->parent;
-				if (current_ == current_->parent->left) // if it is its parent's left child
-					current_ = current_->parent; // ... it becomes its parent
-				else
-					current_ = NULL; // ..else NULL, end is reached
-			}
+			if (is_header_(current_)) // The header knows the leftmost node
+				current_ = current_->left;
+			else
+				current_ = next_node_(current_);
 			return *this;
 		}
 
-		// iterator will cycle backward passing through an end's marker
+		// iterator will cycle backward passing through the end marker
 		aat_iterator &operator--()
 		{
-			root_ = update_root(root_);
-			if (root_ == NIL) // Tree empty ?
-				current_ = NULL;
-			else if (current_ == NULL) // Reached the end ?
-				current_ = rightmost_(root_);
-			else if (current_->left != NIL)
-				current_ = rightmost_(current_->left);
-			else if (current_ == current_->parent->right)
-				current_ = current_->parent;
-			else 
-			{
-				while (current_ == current_->parent->left) // Go up the succession of left children
-					current_ = current_->parent;
-				if (current_ == current_->parent->right) // if it is its parent's right child
-					current_ = current_->parent; // ... it becomes its parent
-				else
-					current_ = NULL; // ..else NULL, end is reached
-			}
+			if (is_header_(current_)) // The header knows the rightmost node
+				current_ = current_->right;
+			else
+				current_ = prev_node_(current_);
 			return *this;
 		}
 
-		aat_iterator & operator++(int)
+		aat_iterator operator++(int)
 		{
 			aat_iterator tmp = *this;
 			operator++();
 			return tmp;
 		}
 
-		aat_iterator & operator--(int)
+		aat_iterator operator--(int)
 		{
 			aat_iterator tmp = *this;
 			operator--();
@@ -766,22 +2599,22 @@ class map
   public:
 	iterator begin()
 	{
-		return ++iterator(root_, NULL);
+		return iterator(header_.left);
 	}
 
 	iterator end()
 	{
-		return iterator(root_, NULL);
+		return iterator(header_node_());
 	}
 
 	const_iterator begin() const
 	{
-		return ++const_iterator(root_, NULL);
+		return const_iterator(header_.left);
 	}
 
 	const_iterator end() const
 	{
-		return const_iterator(root_, NULL);
+		return const_iterator(header_node_());
 	}
 
 	reverse_iterator rbegin()
@@ -807,9 +2640,20 @@ class map
 	/* VALUE COMPARE */
 
 	/* This exists only for forwarding the key_comp function*/
+#if __cplusplus >= 201103L
+	class value_compare // std::binary_function is deprecated, what it gave is spelled out
+	{
+		public:
+		typedef bool        result_type;
+		typedef pair_type_t first_argument_type;
+		typedef pair_type_t second_argument_type;
+
+		protected:
+#else
 	class value_compare : public std::binary_function<pair_type_t, pair_type_t, bool>
 	{
 		protected:
+#endif
 		KeyCmpFn comp;
 		value_compare(KeyCmpFn c) : comp(c)
 		{ }
@@ -820,7 +2664,7 @@ class map
 		bool operator()(pair_type_t const& x, pair_type_t const& y) const { return comp(x.first, y.first); }
 	};
 
-	map<Key, Value, KeyCmpFn, Alloc>::value_compare value_comp() const
+	map<Key, Value, KeyCmpFn, Alloc, Augment>::value_compare value_comp() const
 	{
 		return value_compare(compare_func_);
 
@@ -833,7 +2677,8 @@ class map
 	{
 		if (node != NIL)
 		{
-			ss << node->key() << " [label=< <b>" << node->key() << "</b><br/> <sub>" << node->parent->key() << "</sub>>]\n\t";
+			node_ptr_t parent = is_header_(node->parent) ? node : node->parent;
+			ss << node->key() << " [label=< <b>" << node->key() << "</b><br/> <sub>" << parent->key() << "</sub>>]\n\t";
 			if (node->left != NIL)
 			{
 				if (node->left->level == node->level)
@@ -881,50 +2726,133 @@ class map
 #undef NIL
 }; // class AA_tree
    
-template< class Key, class T, class Compare, class Allocator >
-bool	operator==( map< Key, T, Compare, Allocator > const & x, map< Key, T, Compare, Allocator> const & y )
+template< class Key, class T, class Compare, class Allocator, class Augment >
+bool	operator==( map< Key, T, Compare, Allocator, Augment > const & x, map< Key, T, Compare, Allocator, Augment > const & y )
 {
 	if ( x.size() != y.size() )
 		return false;
 	return ft::equal( x.begin(), x.end(), y.begin() );
 }
 
-template< class Key, class T, class Compare, class Allocator >
-bool	operator<( map< Key, T, Compare, Allocator > const & x, map< Key, T, Compare, Allocator> const & y )
+template< class Key, class T, class Compare, class Allocator, class Augment >
+bool	operator<( map< Key, T, Compare, Allocator, Augment > const & x, map< Key, T, Compare, Allocator, Augment > const & y )
 {
 	return ft::lexicographical_compare( x.begin(), x.end(), y.begin(), y.end() );
 }
 
-template< class Key, class T, class Compare, class Allocator >
-bool	operator!=( map< Key, T, Compare, Allocator > const & x, map< Key, T, Compare, Allocator> const & y )
+template< class Key, class T, class Compare, class Allocator, class Augment >
+bool	operator!=( map< Key, T, Compare, Allocator, Augment > const & x, map< Key, T, Compare, Allocator, Augment > const & y )
 {
 	return !( x == y );
 }
 
-template< class Key, class T, class Compare, class Allocator >
-bool	operator>( map< Key, T, Compare, Allocator > const & x, map< Key, T, Compare, Allocator> const & y )
+template< class Key, class T, class Compare, class Allocator, class Augment >
+bool	operator>( map< Key, T, Compare, Allocator, Augment > const & x, map< Key, T, Compare, Allocator, Augment > const & y )
 {
 	return !( x <= y );
 }
 
-template< class Key, class T, class Compare, class Allocator >
-bool	operator>=( map< Key, T, Compare, Allocator > const & x, map< Key, T, Compare, Allocator> const & y )
+template< class Key, class T, class Compare, class Allocator, class Augment >
+bool	operator>=( map< Key, T, Compare, Allocator, Augment > const & x, map< Key, T, Compare, Allocator, Augment > const & y )
 {
 	return !( x < y );
 }
 
-template< class Key, class T, class Compare, class Allocator >
-bool	operator<=( map< Key, T, Compare, Allocator > const & x, map< Key, T, Compare, Allocator> const & y )
+template< class Key, class T, class Compare, class Allocator, class Augment >
+bool	operator<=( map< Key, T, Compare, Allocator, Augment > const & x, map< Key, T, Compare, Allocator, Augment > const & y )
 {
 	return !( y < x );
 }
 
+// Like C++20's std::erase_if, see map::erase_if() for how it goes about it
+template< class Key, class T, class Compare, class Allocator, class Augment, class Pred >
+typename map< Key, T, Compare, Allocator, Augment >::size_type	erase_if( map< Key, T, Compare, Allocator, Augment > & m, Pred pred )
+{
+	return m.erase_if( pred );
+}
+
+// set operations
+// out gets the result and loses what it held, on equal keys the element of x is the one kept
+// From const maps both operands are copied in O(n), then the in-place members do the work,
+// see map::unite() for parallel_cutoff
+// From C++11 on, maps passed as rvalues are not copied: x's tree becomes the result and y's nodes
+// are relinked into it or destroyed, which leaves only the split and join work
+
+template< class Key, class T, class Compare, class Allocator, class Augment >
+void	map_union( map< Key, T, Compare, Allocator, Augment > const & x, map< Key, T, Compare, Allocator, Augment > const & y,
+	           map< Key, T, Compare, Allocator, Augment > & out, std::size_t parallel_cutoff = 0 )
+{
+	map< Key, T, Compare, Allocator, Augment > result( x );
+	map< Key, T, Compare, Allocator, Augment > source( y );
+
+	result.unite( source, parallel_cutoff );
+	out.swap( result );
+}
+
+#if __cplusplus >= 201103L
+template< class Key, class T, class Compare, class Allocator, class Augment >
+void	map_union( map< Key, T, Compare, Allocator, Augment > && x, map< Key, T, Compare, Allocator, Augment > && y,
+	           map< Key, T, Compare, Allocator, Augment > & out, std::size_t parallel_cutoff = 0 )
+{
+	map< Key, T, Compare, Allocator, Augment > result( std::move(x) );
+
+	result.unite( &x == &y ? result : y, parallel_cutoff ); // The same map twice is what the member does with itself
+	out.swap( result );
+}
+#endif
+
+template< class Key, class T, class Compare, class Allocator, class Augment >
+void	map_intersection( map< Key, T, Compare, Allocator, Augment > const & x, map< Key, T, Compare, Allocator, Augment > const & y,
+	                  map< Key, T, Compare, Allocator, Augment > & out, std::size_t parallel_cutoff = 0 )
+{
+	map< Key, T, Compare, Allocator, Augment > result( x );
+	map< Key, T, Compare, Allocator, Augment > source( y );
+
+	result.intersect( source, parallel_cutoff );
+	out.swap( result );
+}
+
+#if __cplusplus >= 201103L
+template< class Key, class T, class Compare, class Allocator, class Augment >
+void	map_intersection( map< Key, T, Compare, Allocator, Augment > && x, map< Key, T, Compare, Allocator, Augment > && y,
+	                  map< Key, T, Compare, Allocator, Augment > & out, std::size_t parallel_cutoff = 0 )
+{
+	map< Key, T, Compare, Allocator, Augment > result( std::move(x) );
+
+	result.intersect( &x == &y ? result : y, parallel_cutoff ); // The same map twice is what the member does with itself
+	out.swap( result );
+}
+#endif
+
+template< class Key, class T, class Compare, class Allocator, class Augment >
+void	map_difference( map< Key, T, Compare, Allocator, Augment > const & x, map< Key, T, Compare, Allocator, Augment > const & y,
+	                map< Key, T, Compare, Allocator, Augment > & out, std::size_t parallel_cutoff = 0 )
+{
+	map< Key, T, Compare, Allocator, Augment > result( x );
+	map< Key, T, Compare, Allocator, Augment > source( y );
+
+	result.subtract( source, parallel_cutoff );
+	out.swap( result );
+}
+
+#if __cplusplus >= 201103L
+template< class Key, class T, class Compare, class Allocator, class Augment >
+void	map_difference( map< Key, T, Compare, Allocator, Augment > && x, map< Key, T, Compare, Allocator, Augment > && y,
+	                map< Key, T, Compare, Allocator, Augment > & out, std::size_t parallel_cutoff = 0 )
+{
+	map< Key, T, Compare, Allocator, Augment > result( std::move(x) );
+
+	result.subtract( &x == &y ? result : y, parallel_cutoff ); // The same map twice is what the member does with itself
+	out.swap( result );
+}
+#endif
+
 } // namespace ft
 
 // specialized algorithms
 namespace std {
-template< class Key, class T, class Compare, class Allocator >
-void	swap( ft::map< Key, T, Compare, Allocator > & x, ft::map< Key, T, Compare, Allocator > & y )
+template< class Key, class T, class Compare, class Allocator, class Augment >
+void	swap( ft::map< Key, T, Compare, Allocator, Augment > & x, ft::map< Key, T, Compare, Allocator, Augment > & y )
 {
 	x.swap( y );
 	return ;
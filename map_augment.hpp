@@ -0,0 +1,170 @@
+#ifndef MAP_AUGMENT_HPP
+#define MAP_AUGMENT_HPP
+
+#include <cstddef>
+#include <limits>
+
+namespace ft
+{
+
+// Policies for the last template parameter of ft::map, telling what each node
+// keeps about its subtree besides its own element
+
+// The default, nodes carry nothing more than the AA tree needs
+struct no_augment
+{
+};
+
+// Each node knows how many elements its subtree holds
+// which buys rank(), select() and O(log n) distances between iterators
+struct order_statistics
+{
+};
+
+// Each node caches Monoid's combination of the values in its subtree, in key order
+// which buys aggregate(lo, hi) in O(log n), CountsSubtrees adds what order_statistics gives
+// A Monoid looks like this, combine has to be associative, not commutative:
+//   typedef T value_type;              // Mapped values convert to it
+//   static T identity();
+//   static T combine(T const&, T const&);
+template <typename Monoid, bool CountsSubtrees = false>
+struct aggregate
+{
+	typedef Monoid monoid_type;
+};
+
+/* MONOIDS */
+
+template <typename T>
+struct sum_monoid
+{
+	typedef T value_type;
+
+	static T identity() { return T(); }
+	static T combine(T const& a, T const& b) { return a + b; }
+};
+
+template <typename T>
+struct min_monoid
+{
+	typedef T value_type;
+
+	static T identity() { return std::numeric_limits<T>::max(); }
+	static T combine(T const& a, T const& b) { return b < a ? b : a; }
+};
+
+template <typename T>
+struct max_monoid
+{
+	typedef T value_type;
+
+	// min() is the smallest positive value for floating point types
+	static T identity()
+	{
+		return std::numeric_limits<T>::is_integer ? std::numeric_limits<T>::min() : -std::numeric_limits<T>::max();
+	}
+	static T combine(T const& a, T const& b) { return a < b ? b : a; }
+};
+
+// What ft::map::aggregate() returns, void for the policies that have no Monoid
+template <typename Augment>
+struct aggregate_result
+{
+	typedef void type;
+};
+
+template <typename Monoid, bool CountsSubtrees>
+struct aggregate_result<aggregate<Monoid, CountsSubtrees> >
+{
+	typedef typename Monoid::value_type type;
+};
+
+/* NODE PART */
+
+// What a node stores for its policy, a base of every node including NIL
+// recount() works it out from the children, which must already be right, and the node's own value
+// known_size() gives the size of node's subtree when it is kept, false otherwise
+// Empty for no_augment, so the empty base optimization makes it free
+template <typename Augment>
+struct node_augment;
+
+template <>
+struct node_augment<no_augment>
+{
+	static const bool stores_nothing = true;
+
+	template <typename Node, typename Value>
+	void recount(Node const *, Node const *, Value const&) { }
+
+	template <typename Node>
+	static bool known_size(Node const *, std::size_t *) { return false; }
+};
+
+template <>
+struct node_augment<order_statistics>
+{
+	static const bool stores_nothing = false;
+
+	std::size_t subtree_size; // 0 for NIL
+
+	/*Default Constructor*/ node_augment() : subtree_size(0) { }
+
+	template <typename Node, typename Value>
+	void recount(Node const *left, Node const *right, Value const&)
+	{
+		subtree_size = 1 + left->subtree_size + right->subtree_size;
+	}
+
+	template <typename Node>
+	static bool known_size(Node const *node, std::size_t *size)
+	{
+		*size = node->subtree_size;
+		return true;
+	}
+};
+
+template <typename Monoid>
+struct node_augment<aggregate<Monoid, false> >
+{
+	typedef typename Monoid::value_type aggregate_type;
+
+	static const bool stores_nothing = false;
+
+	aggregate_type subtree_aggregate; // The identity for NIL
+
+	/*Default Constructor*/ node_augment() : subtree_aggregate(Monoid::identity()) { }
+
+	template <typename Node, typename Value>
+	void recount(Node const *left, Node const *right, Value const& value)
+	{
+		subtree_aggregate = Monoid::combine(Monoid::combine(left->subtree_aggregate, aggregate_type(value)),
+		                                    right->subtree_aggregate);
+	}
+
+	template <typename Node>
+	static bool known_size(Node const *, std::size_t *) { return false; }
+};
+
+template <typename Monoid>
+struct node_augment<aggregate<Monoid, true> >
+	: node_augment<order_statistics>, node_augment<aggregate<Monoid, false> >
+{
+	static const bool stores_nothing = false;
+
+	template <typename Node, typename Value>
+	void recount(Node const *left, Node const *right, Value const& value)
+	{
+		node_augment<order_statistics>::recount(left, right, value);
+		node_augment<aggregate<Monoid, false> >::recount(left, right, value);
+	}
+
+	template <typename Node>
+	static bool known_size(Node const *node, std::size_t *size)
+	{
+		return node_augment<order_statistics>::known_size(node, size);
+	}
+};
+
+} // namespace ft
+
+#endif /* MAP_AUGMENT_HPP */
@@ -0,0 +1,360 @@
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#if __cplusplus >= 201103L
+# include <atomic>
+#endif
+
+namespace ft
+{
+
+// Hands out uninitialized node storage carved out of slabs of contiguous nodes
+// Freed slots are kept on a free list and reused, slabs go back to the allocator on release()
+// Containers may trade nodes, see share_with(). Pools never touch each other's state:
+// each slab counts the slots held anywhere, and whichever pool gives back its last one frees it
+template <typename Node, typename NodeAlloc>
+class node_pool
+{
+  public:
+	typedef Node                                                         node_t;
+	typedef Node *                                                   node_ptr_t;
+	typedef NodeAlloc                                              node_alloc_t;
+	typedef std::size_t                                               size_type;
+
+  protected:
+	// The smallest power of two from 1024 up that is at least N
+	template <size_type N, size_type P = 1024, bool Enough = (P >= N)>
+	struct round_up_
+	{
+		static size_type const value = round_up_<N, P * 2>::value;
+	};
+
+	template <size_type N, size_type P>
+	struct round_up_<N, P, true>
+	{
+		static size_type const value = P;
+	};
+
+	struct slab_header;
+
+	// Slabs are made of blocks aligned on their size, so that the block a slot is in is
+	// found from the slot's address alone. Every block starts with one of these
+	struct block_header
+	{
+		slab_header *slab;
+	};
+
+	// At the start of a slab's first block
+	struct slab_header : block_header
+	{
+		slab_header *next;     // The pool's other slabs, while it has not traded any node
+		void const  *owner;    // The tag of the pool that made it, see deallocate()
+		node_ptr_t   raw;      // What the allocator gave, the blocks are aligned inside it
+		size_type    raw_size;
+#if __cplusplus >= 201103L
+		std::atomic<size_type> held; // Slots that are in use, free in some pool or not handed out yet
+#else
+		size_type              held;
+#endif
+	};
+
+	// A freed slot is reused to chain the free list
+	struct free_slot
+	{
+		free_slot *next;
+	};
+
+	static size_type const block_bytes_     = round_up_<64 * sizeof(Node)>::value;
+	static size_type const block_slots_     = block_bytes_ / sizeof(Node);
+	static size_type const header_slots_    = (sizeof(slab_header) + sizeof(Node) - 1) / sizeof(Node);
+	static size_type const usable_slots_    = block_slots_ - header_slots_; // Per block
+	static size_type const max_slab_blocks_ = 64;
+
+	/* STATE */
+	node_alloc_t   alloc_;
+	slab_header   *slabs_;
+	free_slot     *free_list_;
+	slab_header   *bump_slab_; // Newest slab, the only one with slots never handed out
+	node_ptr_t     bump_;      // Next never used slot of the current block
+	node_ptr_t     bump_end_;
+	char          *next_block_;
+	char          *slab_end_;
+	size_type      capacity_;  // Usable slots in all slabs this pool made
+	size_type      in_use_;
+	bool           traded_;    // Nodes went between this pool and another
+	void const    *tag_;       // Unique among live pools, it goes along with the slabs on swap()
+
+	static slab_header *slab_of_(void const *p)
+	{
+		std::size_t block = reinterpret_cast<std::size_t>(p) & ~(block_bytes_ - 1);
+		return reinterpret_cast<block_header *>(block)->slab;
+	}
+
+	// Takes n slots off what slab holds, true when they were the last ones
+	static bool let_go_(slab_header *slab, size_type n)
+	{
+#if __cplusplus >= 201103L
+		return slab->held.fetch_sub(n, std::memory_order_acq_rel) == n;
+#elif defined(__GNUC__)
+		return __sync_sub_and_fetch(&slab->held, n) == 0;
+#else
+		return (slab->held -= n) == 0;
+#endif
+	}
+
+	void free_slab_(slab_header *slab)
+	{
+		node_ptr_t raw  = slab->raw;
+		size_type  size = slab->raw_size;
+
+#if __cplusplus >= 201103L
+		slab->held.~atomic();
+#endif
+		alloc_.deallocate(raw, size);
+	}
+
+	void start_block_(char *block)
+	{
+		bump_       = reinterpret_cast<node_ptr_t>(block) + header_slots_;
+		bump_end_   = reinterpret_cast<node_ptr_t>(block) + block_slots_;
+		next_block_ = block + block_bytes_;
+	}
+
+	// Slots never handed out, in the current block and the blocks after it
+	size_type unused_() const
+	{
+		return static_cast<size_type>(bump_end_ - bump_) + static_cast<size_type>(slab_end_ - next_block_) / block_bytes_ * usable_slots_;
+	}
+
+	void add_slab_(size_type nodes)
+	{
+		size_type blocks   = (nodes + usable_slots_ - 1) / usable_slots_;
+		size_type raw_size = ((blocks + 1) * block_bytes_ + sizeof(Node) - 1) / sizeof(Node); // Room to align
+		node_ptr_t raw     = alloc_.allocate(raw_size);
+		std::size_t first  = (reinterpret_cast<std::size_t>(raw) + block_bytes_ - 1) & ~(block_bytes_ - 1);
+		slab_header *slab  = reinterpret_cast<slab_header *>(first);
+
+		// Whatever was left of the previous slab goes to the free list
+		while (bump_ != bump_end_ || next_block_ != slab_end_)
+		{
+			if (bump_ == bump_end_)
+				start_block_(next_block_);
+			push_free_(bump_++);
+		}
+		slab->slab     = slab;
+		slab->next     = slabs_;
+		slab->owner    = tag_;
+		slab->raw      = raw;
+		slab->raw_size = raw_size;
+#if __cplusplus >= 201103L
+		::new (static_cast<void *>(&slab->held)) std::atomic<size_type>(blocks * usable_slots_);
+#else
+		slab->held     = blocks * usable_slots_;
+#endif
+		for (size_type i = 1; i < blocks; ++i)
+			reinterpret_cast<block_header *>(first + i * block_bytes_)->slab = slab;
+		slabs_     = slab;
+		bump_slab_ = slab;
+		slab_end_  = reinterpret_cast<char *>(first) + blocks * block_bytes_;
+		start_block_(reinterpret_cast<char *>(first));
+		capacity_ += blocks * usable_slots_;
+	}
+
+	// Slabs double in size, within bounds
+	// As many slots as are in use rather than as were ever made, the slabs of a pool
+	// that traded nodes may be gone to other pools and freed by now
+	size_type next_slab_size_() const
+	{
+		if (in_use_ < usable_slots_)
+			return usable_slots_;
+		if (in_use_ > max_slab_blocks_ * usable_slots_)
+			return max_slab_blocks_ * usable_slots_;
+		return in_use_;
+	}
+
+	void push_free_(node_ptr_t p)
+	{
+		free_slot *slot = reinterpret_cast<free_slot *>(p);
+		slot->next = free_list_;
+		free_list_ = slot;
+	}
+
+	// Gives back every slot this pool holds, slab by slab, freeing the slabs nobody holds anything of anymore
+	void let_go_of_slots_()
+	{
+		slab_header *run   = NULL; // Consecutive slots of the same slab are given back at once
+		size_type    count = 0;
+
+		for (free_slot *slot = free_list_; slot != NULL; slot = slot->next)
+		{
+			slab_header *slab = slab_of_(slot);
+			if (slab != run)
+			{
+				if (run != NULL && let_go_(run, count))
+					free_slab_(run);
+				run   = slab;
+				count = 0;
+			}
+			++count;
+		}
+		if (run != NULL && let_go_(run, count))
+			free_slab_(run);
+		size_type unused = unused_(); // Nothing to give back otherwise, and the slab may be gone
+		if (unused > 0 && let_go_(bump_slab_, unused))
+			free_slab_(bump_slab_);
+	}
+
+  private:
+	// Slots are handed out by address, a pool can't be copied
+	node_pool(node_pool const &);
+	node_pool &operator=(node_pool const &);
+
+  public:
+	/*Constructor*/ explicit node_pool(node_alloc_t const &alloc) :
+		alloc_(alloc),
+		slabs_(NULL),
+		free_list_(NULL),
+		bump_slab_(NULL),
+		bump_(NULL),
+		bump_end_(NULL),
+		next_block_(NULL),
+		slab_end_(NULL),
+		capacity_(0),
+		in_use_(0),
+		traded_(false),
+		tag_(this)
+	{ }
+
+	/*Destructor*/ ~node_pool()
+	{
+		release();
+	}
+
+	node_ptr_t allocate()
+	{
+		node_ptr_t p;
+
+		if (free_list_ != NULL)
+		{
+			p          = reinterpret_cast<node_ptr_t>(free_list_);
+			free_list_ = free_list_->next;
+		}
+		else
+		{
+			if (bump_ == bump_end_)
+			{
+				if (next_block_ != slab_end_)
+					start_block_(next_block_);
+				else
+					add_slab_(next_slab_size_());
+			}
+			p = bump_++;
+		}
+		++in_use_;
+		return p;
+	}
+
+	// Storage must not hold a live object anymore, it may come from any pool this one traded with
+	// Slots of other pools' slabs are given back right away, kept here they would keep their slabs alive
+	void deallocate(node_ptr_t p)
+	{
+		--in_use_;
+		if (traded_)
+		{
+			slab_header *slab = slab_of_(p);
+			if (slab->owner != tag_)
+			{
+				if (let_go_(slab, 1))
+					free_slab_(slab);
+				return ;
+			}
+		}
+		push_free_(p);
+	}
+
+	// Makes sure the next n allocations won't need to ask the allocator
+	// Only a hint once nodes were traded, some of ours may be in other pools
+	void reserve(size_type n)
+	{
+		size_type available = in_use_ < capacity_ ? capacity_ - in_use_ : 0;
+
+		if (n > available)
+			add_slab_(n - available);
+	}
+
+	// Lets go of every slab, live objects must have been destroyed
+	// Once nodes were traded, every slot must have been given back with deallocate() first:
+	// slabs then only go when no pool holds anything of them anymore
+	void release()
+	{
+		if (traded_)
+			let_go_of_slots_();
+		else
+		{
+			while (slabs_ != NULL)
+			{
+				slab_header *next = slabs_->next;
+				free_slab_(slabs_);
+				slabs_ = next;
+			}
+		}
+		slabs_      = NULL;
+		free_list_  = NULL;
+		bump_slab_  = NULL;
+		bump_       = NULL;
+		bump_end_   = NULL;
+		next_block_ = NULL;
+		slab_end_   = NULL;
+		capacity_   = 0;
+		in_use_     = 0;
+		traded_     = false;
+	}
+
+	void swap(node_pool &other)
+	{
+		std::swap(alloc_, other.alloc_);
+		std::swap(slabs_, other.slabs_);
+		std::swap(free_list_, other.free_list_);
+		std::swap(bump_slab_, other.bump_slab_);
+		std::swap(bump_, other.bump_);
+		std::swap(bump_end_, other.bump_end_);
+		std::swap(next_block_, other.next_block_);
+		std::swap(slab_end_, other.slab_end_);
+		std::swap(capacity_, other.capacity_);
+		std::swap(in_use_, other.in_use_);
+		std::swap(traded_, other.traded_);
+		std::swap(tag_, other.tag_);
+	}
+
+	// From now on nodes from either pool may be given back to the other
+	// Both give back their slots one by one on release(), other pools included
+	// The allocators must compare equal
+	void share_with(node_pool &other)
+	{
+		traded_       = true;
+		other.traded_ = true;
+	}
+
+	// Books n nodes in use as belonging to other now, for when containers trade nodes
+	void transfer_in_use(node_pool &other, size_type n)
+	{
+		in_use_       -= n;
+		other.in_use_ += n;
+	}
+
+	size_type capacity() const { return capacity_; }
+#if __cplusplus >= 201103L
+	size_type max_size() const { return std::allocator_traits<node_alloc_t>::max_size(alloc_); }
+#else
+	size_type max_size() const { return alloc_.max_size(); }
+#endif
+	node_alloc_t const &get_allocator() const { return alloc_; }
+};
+
+} // namespace ft
+
+#endif /* NODE_POOL_HPP */
@@ -1,9 +1,34 @@
 #ifndef PAIR_HPP
 #define PAIR_HPP
 
+#if __cplusplus >= 201103L
+# include <cstddef>
+# include <tuple>
+# include <utility>
+#endif
+
 namespace ft
 {
 
+#if __cplusplus >= 201103L
+// 0 to N - 1 as a pack, for taking tuples apart
+template <std::size_t... I>
+struct index_list
+{
+};
+
+template <std::size_t N, std::size_t... I>
+struct make_index_list : make_index_list<N - 1, N - 1, I...>
+{
+};
+
+template <std::size_t... I>
+struct make_index_list<0, I...>
+{
+	typedef index_list<I...> type;
+};
+#endif
+
 template <typename T1, typename T2>
 struct pair
 {
@@ -30,6 +55,43 @@ struct pair
 	pair(const pair<U1, U2>& p) : first(p.first), second(p.second)
 	{
 	}
+
+#if __cplusplus >= 201103L
+	// What std::pair takes as well, so that elements can be built in place
+	template <typename U1, typename U2>
+	pair(U1&& a, U2&& b) : first(std::forward<U1>(a)), second(std::forward<U2>(b))
+	{
+	}
+
+	template <typename U1, typename U2>
+	pair(pair<U1, U2>&& p) : first(std::forward<U1>(p.first)), second(std::forward<U2>(p.second))
+	{
+	}
+
+	template <typename U1, typename U2>
+	pair(const std::pair<U1, U2>& p) : first(p.first), second(p.second)
+	{
+	}
+
+	template <typename U1, typename U2>
+	pair(std::pair<U1, U2>&& p) : first(std::forward<U1>(p.first)), second(std::forward<U2>(p.second))
+	{
+	}
+
+	template <typename... Args1, typename... Args2>
+	pair(std::piecewise_construct_t, std::tuple<Args1...> a, std::tuple<Args2...> b) :
+		pair(a, b, typename make_index_list<sizeof...(Args1)>::type(), typename make_index_list<sizeof...(Args2)>::type())
+	{
+	}
+
+  private:
+	template <typename... Args1, typename... Args2, std::size_t... I1, std::size_t... I2>
+	pair(std::tuple<Args1...>& a, std::tuple<Args2...>& b, index_list<I1...>, index_list<I2...>) :
+		first(std::forward<Args1>(std::get<I1>(a))...),
+		second(std::forward<Args2>(std::get<I2>(b))...)
+	{
+	}
+#endif
 };
 
 template <typename T1, typename T2>
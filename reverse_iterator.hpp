@@ -27,6 +27,19 @@ template <typename Iterator>
   protected:
 	Iterator current_;
 
+	// What -> gives: the iterator's own -> for classes, whose references may be proxies with no address
+	template <typename It>
+	static typename iterator_traits<It>::pointer arrow_(It const& it)
+	{
+		return it.operator->();
+	}
+
+	template <typename T>
+	static T *arrow_(T *p)
+	{
+		return p;
+	}
+
   public:
 	/// EXPOSED TYPES
 	
@@ -45,7 +58,7 @@ template <typename Iterator>
 
 	// We must write a default ctor because we have written a value constructor
 
-	/*defautl ctor*/ reverse_iterator() : current_(0) 
+	/*defautl ctor*/ reverse_iterator() : current_()
 	{
 		  /**
 		   *  The default constructor value-initializes member @p current.
@@ -65,7 +78,7 @@ template <typename Iterator>
 	}
 
 	template <class OtherIter>
-		reverse_iterator (const reverse_iterator<OtherIter>& rev_it) : current_(rev_it.current_)
+		reverse_iterator (const reverse_iterator<OtherIter>& rev_it) : current_(rev_it.base())
 	{
 	/**
 	 *  A %reverse_iterator across other types can be copied if the
@@ -84,6 +97,7 @@ template <typename Iterator>
 
 	/// DEREFERENCING OPERATORS
 	
+	// Worked out again on every dereference, the element before current_ may have changed since
 	reference operator* () const
 	{
 		iterator_type tmp = current_;
@@ -93,7 +107,9 @@ template <typename Iterator>
 
 	pointer operator->() const
 	{
-		return &(operator*());
+		iterator_type tmp = current_;
+		--tmp;
+		return arrow_(tmp);
 	}
 
 	reference operator[] (difference_type i) const
@@ -109,10 +125,10 @@ template <typename Iterator>
 		return *this;
 	}
 
-	reverse_iterator& operator++ (int)
+	reverse_iterator operator++ (int)
 	{
 		reverse_iterator tmp = *this;
-		--current_;
+		operator++();
 		return tmp;
 	}
 
@@ -124,10 +140,10 @@ template <typename Iterator>
 		return *this;
 	}
 
-	reverse_iterator& operator-- (int)
+	reverse_iterator operator-- (int)
 	{
 		reverse_iterator tmp = *this;
-		++current_;
+		operator--();
 		return tmp;
 	}
 
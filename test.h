@@ -3,6 +3,9 @@
 
 # include "vector.hpp"
 # include "map.hpp"
+# include "btree_map.hpp"
+# include "flat_map.hpp"
+# include "compact_map.hpp"
 
 #include <vector>
 #include <map>
@@ -18,6 +21,54 @@ using NAMESPACE::vector;
 //using NAMESPACE::stack;
 using NAMESPACE::map;
 
+// std has no B-tree: on that side of the diff, the btree_map tests run on std::map
+#define BTREE_MAP_ft      ft::btree_map
+#define BTREE_MAP_std     std::map
+#define BTREE_MAP_IN_(ns) BTREE_MAP_##ns
+#define BTREE_MAP_IN(ns)  BTREE_MAP_IN_(ns)
+#define BTREE_MAP         BTREE_MAP_IN(NAMESPACE)
+
+// ft::map counting its subtrees, std::map gets the same answers by walking
+#define COUNTED_INT_MAP_ft      ft::map<int, int, std::less<int>, std::allocator<std::pair<const int, int> >, ft::order_statistics>
+#define COUNTED_INT_MAP_std     std::map<int, int>
+#define COUNTED_INT_MAP_IN_(ns) COUNTED_INT_MAP_##ns
+#define COUNTED_INT_MAP_IN(ns)  COUNTED_INT_MAP_IN_(ns)
+#define COUNTED_INT_MAP         COUNTED_INT_MAP_IN(NAMESPACE)
+
+// Same with the sum of the values in every subtree
+#define SUMMED_INT_MAP_ft      ft::map<int, int, std::less<int>, std::allocator<std::pair<const int, int> >, ft::aggregate<ft::sum_monoid<long> > >
+#define SUMMED_INT_MAP_std     std::map<int, int>
+#define SUMMED_INT_MAP_IN_(ns) SUMMED_INT_MAP_##ns
+#define SUMMED_INT_MAP_IN(ns)  SUMMED_INT_MAP_IN_(ns)
+#define SUMMED_INT_MAP         SUMMED_INT_MAP_IN(NAMESPACE)
+
+// Same for flat_map
+#define FLAT_MAP_ft       ft::flat_map
+#define FLAT_MAP_std      std::map
+#define FLAT_MAP_IN_(ns)  FLAT_MAP_##ns
+#define FLAT_MAP_IN(ns)   FLAT_MAP_IN_(ns)
+#define FLAT_MAP          FLAT_MAP_IN(NAMESPACE)
+
+// Same for compact_map
+#define COMPACT_MAP_ft      ft::compact_map
+#define COMPACT_MAP_std     std::map
+#define COMPACT_MAP_IN_(ns) COMPACT_MAP_##ns
+#define COMPACT_MAP_IN(ns)  COMPACT_MAP_IN_(ns)
+#define COMPACT_MAP         COMPACT_MAP_IN(NAMESPACE)
+
+// compact_map keeping its values out of the nodes
+#define SEPARATE_STRING_MAP_ft      ft::compact_map<int, std::string, std::less<int>, std::allocator<std::pair<const int, std::string> >, ft::separate_values>
+#define SEPARATE_STRING_MAP_std     std::map<int, std::string>
+#define SEPARATE_STRING_MAP_IN_(ns) SEPARATE_STRING_MAP_##ns
+#define SEPARATE_STRING_MAP_IN(ns)  SEPARATE_STRING_MAP_IN_(ns)
+#define SEPARATE_STRING_MAP         SEPARATE_STRING_MAP_IN(NAMESPACE)
+
+// Nonzero in the std build only, for code that one side of the diff has no use for
+#define ON_STD_SIDE_std     1
+#define ON_STD_SIDE_IN_(ns) ON_STD_SIDE_##ns
+#define ON_STD_SIDE_IN(ns)  ON_STD_SIDE_IN_(ns)
+#define ON_STD_SIDE         ON_STD_SIDE_IN(NAMESPACE)
+
 using std::cout;
 using std::string;
 
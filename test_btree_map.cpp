@@ -0,0 +1,261 @@
+#include <exception>
+#include <iostream>
+
+#include "test.h"
+#include "test_btree_map.hpp"
+
+// Insertions and erasures invalidate btree_map iterators, so unlike the map
+// tests these never hold on to one across a modification
+
+typedef BTREE_MAP<int, int> int_btree;
+
+// Enough elements for a tree a few nodes deep
+static int const big = 5000;
+
+static void print_summary(int_btree const& tree)
+{
+	long sum     = 0;
+	long ordered = 1;
+	int  prev    = 0;
+
+	for (int_btree::const_iterator it = tree.begin(); it != tree.end(); ++it)
+	{
+		if (it != tree.begin() && !(prev < it->first))
+			ordered = 0;
+		prev = it->first;
+		sum += it->first * 3 + it->second;
+	}
+	std::cout << "size " << tree.size() << " sum " << sum << " ordered " << ordered << std::endl;
+}
+
+int test_btree_map()
+{
+	test_btree_map_begin();
+	test_btree_map_clear();
+	test_btree_map_constructor();
+	test_btree_map_copy();
+	test_btree_map_erase();
+	test_btree_map_insert();
+	test_btree_map_lookup();
+	test_btree_map_rbegin();
+	test_btree_map_swap();
+	return 0;
+}
+
+int	test_btree_map_begin()
+{
+	BTREE_MAP<char, int> tree;
+
+	tree['b'] = 100;
+	tree['a'] = 200;
+	tree['c'] = 300;
+
+	for ( BTREE_MAP<char, int>::iterator it = tree.begin(); it != tree.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	return 0;
+}
+
+int	test_btree_map_clear()
+{
+	int_btree tree;
+
+	for (int i = 0; i < big; ++i)
+		tree[i] = i;
+	tree.clear();
+	std::cout << "cleared: " << tree.size() << " " << (tree.begin() == tree.end()) << std::endl;
+	tree[2] = 2202;
+	tree[1] = 1101;
+	for ( int_btree::iterator it = tree.begin(); it != tree.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	return 0;
+}
+
+int	test_btree_map_constructor()
+{
+	NAMESPACE::pair<int, int> unsorted[] = {
+		NAMESPACE::make_pair(8, 80), NAMESPACE::make_pair(3, 30), NAMESPACE::make_pair(5, 50),
+		NAMESPACE::make_pair(3, 31), NAMESPACE::make_pair(1, 10), NAMESPACE::make_pair(2, 20)
+	};
+	int_btree first(unsorted, unsorted + 6);
+	std::cout << "first contains " << first.size() << " elements:" << std::endl;
+	for ( int_btree::iterator it = first.begin(); it != first.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	// Sorted ingest, every element goes right before end()
+	static NAMESPACE::pair<int, int> sorted[big];
+	for (int i = 0; i < big; ++i)
+		sorted[i] = NAMESPACE::make_pair(i * 2, i);
+	int_btree second(sorted, sorted + big);
+	print_summary(second);
+
+	int_btree third(second.find(1000), second.end());
+	third.insert(unsorted, unsorted + 6);
+	print_summary(third);
+
+	return 0;
+}
+
+int	test_btree_map_copy()
+{
+	int_btree tree;
+
+	for (int i = 0; i < big; ++i)
+		tree[(i * 37) % big] = i;
+
+	int_btree copy(tree);
+	tree.erase(5);
+	copy[-1] = -1;
+	print_summary(tree);
+	print_summary(copy);
+
+	int_btree assigned;
+	assigned[42] = 42;
+	assigned = copy;
+	assigned = assigned;
+	print_summary(assigned);
+	std::cout << "copy == assigned: " << (copy == assigned) << ", tree < copy: " << (tree < copy) << std::endl;
+
+	return 0;
+}
+
+int	test_btree_map_erase()
+{
+	int_btree tree;
+
+	for (int i = 0; i < 64; ++i)
+		tree[(i * 37) % 64] = i;
+	for (int i = 0; i < 64; i += 3)
+		std::cout << "erase(" << i << ") returned " << tree.erase(i) << std::endl;
+	std::cout << "erase(3) again returned " << tree.erase(3) << std::endl;
+	tree.erase(tree.find(10));
+	tree.erase(tree.find(20), tree.find(50));
+	for ( int_btree::iterator it = tree.begin(); it != tree.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	// Deep tree, erasing enough to merge nodes all the way up
+	for (int i = 0; i < big; ++i)
+		tree[(i * 7919) % big] = i;
+	for (int i = 0; i < big; i += 2)
+		tree.erase((i * 31) % big);
+	print_summary(tree);
+	tree.erase(tree.lower_bound(1000), tree.upper_bound(4000));
+	print_summary(tree);
+	tree.erase(tree.begin(), tree.find(4001));
+	print_summary(tree);
+	for (int i = 0; i < big; ++i)
+		tree.erase(i);
+	print_summary(tree);
+	std::cout << "empty: " << tree.empty() << std::endl;
+
+	return 0;
+}
+
+int	test_btree_map_insert()
+{
+	int_btree tree;
+	NAMESPACE::pair<int_btree::iterator, bool> ret;
+
+	ret = tree.insert(NAMESPACE::make_pair(10, 100));
+	std::cout << "inserted " << ret.first->first << ": " << ret.second << std::endl;
+	ret = tree.insert(NAMESPACE::make_pair(10, 200));
+	std::cout << "inserted " << ret.first->first << "=>" << ret.first->second << ": " << ret.second << std::endl;
+
+	// Good hints, then bad ones and already present keys
+	int_btree::iterator hint = tree.end();
+	for (int i = 20; i < 2000; i += 2)
+		hint = tree.insert(hint, NAMESPACE::make_pair(i, i));
+	for (int i = 0; i < 10; ++i)
+		tree.insert(tree.end(), NAMESPACE::make_pair(5000 + i, i));
+	tree.insert(tree.find(50), NAMESPACE::make_pair(49, -49));
+	tree.insert(tree.find(50), NAMESPACE::make_pair(51, -51));
+	for (int i = 1999; i > 1000; i -= 2)
+		tree.insert(tree.find(i + 1), NAMESPACE::make_pair(i, -i));
+	tree.insert(tree.begin(), NAMESPACE::make_pair(3000, 3000));
+	tree.insert(tree.end(), NAMESPACE::make_pair(5, 5));
+	hint = tree.insert(tree.find(60), NAMESPACE::make_pair(30, -1));
+	std::cout << "hinted insert returned " << hint->first << "=>" << hint->second << std::endl;
+	print_summary(tree);
+
+	return 0;
+}
+
+int	test_btree_map_lookup()
+{
+	int_btree tree;
+
+	for (int i = 0; i < big; ++i)
+		tree[i * 3] = i;
+
+	int_btree const& ctree = tree;
+	int probes[] = { -1, 0, 1, 2, 3, 299, 300, 301, 7499, 14997, 14998, 20000 };
+	for (unsigned i = 0; i < sizeof(probes) / sizeof(*probes); ++i)
+	{
+		int k = probes[i];
+		int_btree::const_iterator lo = ctree.lower_bound(k);
+		int_btree::iterator       hi = tree.upper_bound(k);
+		std::cout << k << ": count " << tree.count(k)
+		          << " find " << (tree.find(k) == tree.end() ? -1 : tree.find(k)->second)
+		          << " lower " << (lo == ctree.end() ? -1 : lo->first)
+		          << " upper " << (hi == tree.end() ? -1 : hi->first)
+		          << " range " << (tree.equal_range(k).first != tree.equal_range(k).second) << std::endl;
+	}
+
+	return 0;
+}
+
+int	test_btree_map_rbegin()
+{
+	int_btree tree;
+
+	for (int i = 0; i < big; ++i)
+		tree[(i * 7) % big] = i;
+
+	long sum = 0;
+	int  n   = 0;
+	for ( int_btree::reverse_iterator it = tree.rbegin(); it != tree.rend(); ++it, ++n)
+		sum += (n % 7) * it->first + (*it).second;
+	std::cout << "backwards: " << n << " " << sum << std::endl;
+
+	int_btree::const_reverse_iterator rit = tree.rbegin();
+	rit++;
+	std::cout << "second to last: " << rit->first << std::endl;
+	int_btree::iterator last = tree.end();
+	--last;
+	std::cout << "last: " << last->first << std::endl;
+	int_btree::iterator it = tree.find(2500);
+	--it;
+	--it;
+	++it;
+	std::cout << "before 2500: " << it->first << std::endl;
+
+	return 0;
+}
+
+int	test_btree_map_swap()
+{
+	BTREE_MAP<char, int> foo, bar;
+
+	foo['x'] = 100;
+	foo['y'] = 200;
+	bar['a'] = 11;
+	bar['b'] = 22;
+	bar['c'] = 33;
+
+	foo.swap(bar);
+	bar['z'] = 300;
+
+	std::cout << "foo contains:" << std::endl;
+	for ( BTREE_MAP<char, int>::iterator it = foo.begin(); it != foo.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+	std::cout << "bar contains:" << std::endl;
+	for ( BTREE_MAP<char, int>::iterator it = bar.begin(); it != bar.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	BTREE_MAP<char, int> empty;
+	empty.swap(foo);
+	std::cout << "foo is now " << (foo.begin() == foo.end() ? "empty" : "not empty") << std::endl;
+
+	return 0;
+}
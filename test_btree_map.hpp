@@ -0,0 +1,15 @@
+#ifndef TEST_BTREE_MAP_HPP
+#define TEST_BTREE_MAP_HPP
+
+int test_btree_map();
+int test_btree_map_begin();
+int test_btree_map_clear();
+int test_btree_map_constructor();
+int test_btree_map_copy();
+int test_btree_map_erase();
+int test_btree_map_insert();
+int test_btree_map_lookup();
+int test_btree_map_rbegin();
+int test_btree_map_swap();
+
+#endif /* TEST_BTREE_MAP_HPP */
@@ -0,0 +1,318 @@
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "test.h"
+#include "test_compact_map.hpp"
+
+// Like btree_map, inserting or erasing invalidates compact_map iterators, and
+// erasing moves the last slot into the freed one, so these never hold on to
+// an iterator across a modification either
+
+typedef COMPACT_MAP<int, int> int_compact;
+
+// Enough elements for the array to grow a few times and the tree to get tall
+static int const big = 5000;
+
+static void print_summary(int_compact const& tree)
+{
+	long sum     = 0;
+	long ordered = 1;
+	int  prev    = 0;
+
+	for (int_compact::const_iterator it = tree.begin(); it != tree.end(); ++it)
+	{
+		if (it != tree.begin() && !(prev < it->first))
+			ordered = 0;
+		prev = it->first;
+		sum += it->first * 3 + it->second;
+	}
+	std::cout << "size " << tree.size() << " sum " << sum << " ordered " << ordered << std::endl;
+}
+
+int test_compact_map()
+{
+	test_compact_map_begin();
+	test_compact_map_constructor();
+	test_compact_map_copy();
+	test_compact_map_erase();
+	test_compact_map_insert();
+	test_compact_map_lookup();
+	test_compact_map_rbegin();
+	test_compact_map_separate();
+	test_compact_map_swap();
+	return 0;
+}
+
+int	test_compact_map_begin()
+{
+	COMPACT_MAP<char, int> tree;
+
+	tree['b'] = 100;
+	tree['a'] = 200;
+	tree['c'] = 300;
+
+	for ( COMPACT_MAP<char, int>::iterator it = tree.begin(); it != tree.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	tree.clear();
+	std::cout << "cleared: " << tree.size() << " " << (tree.begin() == tree.end()) << std::endl;
+	tree['z'] = 1;
+	std::cout << tree.begin()->first << "=>" << tree.begin()->second << std::endl;
+
+	return 0;
+}
+
+int	test_compact_map_constructor()
+{
+	NAMESPACE::pair<int, int> unsorted[] = {
+		NAMESPACE::make_pair(8, 80), NAMESPACE::make_pair(3, 30), NAMESPACE::make_pair(5, 50),
+		NAMESPACE::make_pair(3, 31), NAMESPACE::make_pair(1, 10), NAMESPACE::make_pair(2, 20)
+	};
+	int_compact first(unsorted, unsorted + 6);
+	std::cout << "first contains " << first.size() << " elements:" << std::endl;
+	for ( int_compact::iterator it = first.begin(); it != first.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	// Sorted ingest, every element goes right before end()
+	static NAMESPACE::pair<int, int> sorted[big];
+	for (int i = 0; i < big; ++i)
+		sorted[i] = NAMESPACE::make_pair(i * 2, i);
+	int_compact second(sorted, sorted + big);
+	print_summary(second);
+
+	int_compact third(second.find(1000), second.end());
+	third.insert(unsorted, unsorted + 6);
+	print_summary(third);
+
+	// Elements that own memory, moved around when the array grows and when slots are refilled
+	COMPACT_MAP<std::string, std::string> words;
+	for (int i = 0; i < 200; ++i)
+		words[std::string(1, static_cast<char>('a' + i % 26)) + std::string(i / 26 + 1, 'x')] = std::string(i % 7 + 20, 'w');
+	for (int i = 0; i < 200; i += 3)
+		words.erase(std::string(1, static_cast<char>('a' + i % 26)) + std::string(i / 26 + 1, 'x'));
+	std::size_t length = 0;
+	for (COMPACT_MAP<std::string, std::string>::iterator it = words.begin(); it != words.end(); ++it)
+		length += it->first.size() + it->second.size();
+	std::cout << "words: " << words.size() << " " << length << " " << words.begin()->first << " " << words.rbegin()->first << std::endl;
+
+	return 0;
+}
+
+int	test_compact_map_copy()
+{
+	int_compact tree;
+
+	for (int i = 0; i < big; ++i)
+		tree[(i * 37) % big] = i;
+
+	int_compact copy(tree);
+	tree.erase(5);
+	copy[-1] = -1;
+	print_summary(tree);
+	print_summary(copy);
+
+	int_compact assigned;
+	assigned[42] = 42;
+	assigned = copy;
+	assigned = assigned;
+	print_summary(assigned);
+	std::cout << "copy == assigned: " << (copy == assigned) << ", tree < copy: " << (tree < copy) << std::endl;
+
+	return 0;
+}
+
+int	test_compact_map_erase()
+{
+	int_compact tree;
+
+	for (int i = 0; i < 64; ++i)
+		tree[(i * 37) % 64] = i;
+	for (int i = 0; i < 64; i += 3)
+		std::cout << "erase(" << i << ") returned " << tree.erase(i) << std::endl;
+	std::cout << "erase(3) again returned " << tree.erase(3) << std::endl;
+	tree.erase(tree.find(10));
+	tree.erase(tree.find(20), tree.find(50));
+	for ( int_compact::iterator it = tree.begin(); it != tree.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	// Erasing the root and internal nodes over and over, in an order that keeps refilling slots
+	for (int i = 0; i < big; ++i)
+		tree[(i * 7919) % big] = i;
+	for (int i = 0; i < big; i += 2)
+		tree.erase((i * 31) % big);
+	print_summary(tree);
+	tree.erase(tree.lower_bound(1000), tree.upper_bound(4000));
+	print_summary(tree);
+	tree.erase(tree.begin(), tree.find(4001));
+	print_summary(tree);
+	for (int i = 0; i < big; ++i)
+		tree.erase(i);
+	print_summary(tree);
+	std::cout << "empty: " << tree.empty() << std::endl;
+
+	return 0;
+}
+
+int	test_compact_map_insert()
+{
+	int_compact tree;
+	NAMESPACE::pair<int_compact::iterator, bool> ret;
+
+	ret = tree.insert(NAMESPACE::make_pair(10, 100));
+	std::cout << "inserted " << ret.first->first << ": " << ret.second << std::endl;
+	ret = tree.insert(NAMESPACE::make_pair(10, 200));
+	std::cout << "inserted " << ret.first->first << "=>" << ret.first->second << ": " << ret.second << std::endl;
+
+	// Good hints, then bad ones and already present keys
+	int_compact::iterator hint = tree.end();
+	for (int i = 20; i < 2000; i += 2)
+		hint = tree.insert(hint, NAMESPACE::make_pair(i, i));
+	for (int i = 0; i < 10; ++i)
+		tree.insert(tree.end(), NAMESPACE::make_pair(5000 + i, i));
+	tree.insert(tree.find(50), NAMESPACE::make_pair(49, -49));
+	tree.insert(tree.find(50), NAMESPACE::make_pair(51, -51));
+	for (int i = 1999; i > 1000; i -= 2)
+		tree.insert(tree.find(i + 1), NAMESPACE::make_pair(i, -i));
+	tree.insert(tree.begin(), NAMESPACE::make_pair(3000, 3000));
+	tree.insert(tree.begin(), NAMESPACE::make_pair(1, 1));
+	tree.insert(tree.end(), NAMESPACE::make_pair(5, 5));
+	hint = tree.insert(tree.find(60), NAMESPACE::make_pair(30, -1));
+	std::cout << "hinted insert returned " << hint->first << "=>" << hint->second << std::endl;
+	hint = tree.insert(tree.find(60), NAMESPACE::make_pair(60, -1));
+	std::cout << "hinted insert returned " << hint->first << "=>" << hint->second << std::endl;
+	print_summary(tree);
+
+	return 0;
+}
+
+int	test_compact_map_lookup()
+{
+	int_compact tree;
+
+	for (int i = 0; i < big; ++i)
+		tree[i * 3] = i;
+
+	int_compact const& ctree = tree;
+	int probes[] = { -1, 0, 1, 2, 3, 299, 300, 301, 7499, 14997, 14998, 20000 };
+	for (unsigned i = 0; i < sizeof(probes) / sizeof(*probes); ++i)
+	{
+		int k = probes[i];
+		int_compact::const_iterator lo = ctree.lower_bound(k);
+		int_compact::iterator       hi = tree.upper_bound(k);
+		std::cout << k << ": count " << tree.count(k)
+		          << " find " << (tree.find(k) == tree.end() ? -1 : tree.find(k)->second)
+		          << " lower " << (lo == ctree.end() ? -1 : lo->first)
+		          << " upper " << (hi == tree.end() ? -1 : hi->first)
+		          << " range " << (tree.equal_range(k).first != tree.equal_range(k).second) << std::endl;
+	}
+
+	// Walking on from what a lookup returned
+	int_compact::iterator it = tree.find(3000);
+	long                  sum = 0;
+	for (int n = 0; n < 100; ++n, ++it)
+		sum += it->first;
+	for (int n = 0; n < 250; ++n)
+		sum += (--it)->second;
+	std::cout << "walked: " << sum << " " << it->first << std::endl;
+
+	return 0;
+}
+
+int	test_compact_map_rbegin()
+{
+	int_compact tree;
+
+	for (int i = 0; i < big; ++i)
+		tree[(i * 7) % big] = i;
+
+	long sum = 0;
+	int  n   = 0;
+	for ( int_compact::reverse_iterator it = tree.rbegin(); it != tree.rend(); ++it, ++n)
+		sum += (n % 7) * it->first + (*it).second;
+	std::cout << "backwards: " << n << " " << sum << std::endl;
+
+	int_compact::const_reverse_iterator rit = tree.rbegin();
+	rit++;
+	std::cout << "second to last: " << rit->first << std::endl;
+	int_compact::iterator last = tree.end();
+	--last;
+	std::cout << "last: " << last->first << std::endl;
+	int_compact::iterator it = tree.find(2500);
+	--it;
+	--it;
+	++it;
+	std::cout << "before 2500: " << it->first << std::endl;
+
+	return 0;
+}
+
+// Values in an array of their own, iterators give pairs of references
+int	test_compact_map_separate()
+{
+	typedef SEPARATE_STRING_MAP separate_map;
+
+	separate_map tree;
+
+	for (int i = 0; i < big; ++i)
+		tree[(i * 37) % big] = std::string(i % 23 + 1, static_cast<char>('a' + i % 26));
+	for (int i = 0; i < big; i += 3)
+		tree.erase((i * 11) % big);
+	tree.erase(tree.find(40), tree.find(400));
+	tree.insert(NAMESPACE::make_pair(-1, std::string("first")));
+	tree.insert(tree.end(), NAMESPACE::make_pair(big, std::string("last")));
+
+	std::size_t length = 0;
+	long        keys   = 0;
+	for (separate_map::iterator it = tree.begin(); it != tree.end(); ++it)
+	{
+		length += it->second.size();
+		keys   += (*it).first;
+	}
+	std::cout << "separate: " << tree.size() << " " << length << " " << keys << std::endl;
+
+	// Writing through an iterator, ->, * and operator[] all reach the same value
+	tree.find(1)->second = "one";
+	(*tree.find(2)).second += "two";
+	tree[3].append("three");
+	separate_map::const_reverse_iterator rit = tree.rbegin();
+	std::cout << rit->first << "=>" << rit->second << ", " << (++rit)->first << std::endl;
+	NAMESPACE::pair<const int, std::string> copied = *tree.find(2);
+	std::cout << tree.find(1)->second << " " << copied.first << "=>" << copied.second << " " << tree[3] << std::endl;
+
+	separate_map copy(tree);
+	std::cout << "copy == tree: " << (copy == tree);
+	copy[5] = "changed";
+	std::cout << ", copy < tree: " << (copy < tree) << ", tree < copy: " << (tree < copy) << std::endl;
+	copy.swap(tree);
+	std::cout << tree[5] << " " << copy[5] << std::endl;
+
+	return 0;
+}
+
+int	test_compact_map_swap()
+{
+	COMPACT_MAP<char, int> foo, bar;
+
+	foo['x'] = 100;
+	foo['y'] = 200;
+	bar['a'] = 11;
+	bar['b'] = 22;
+	bar['c'] = 33;
+
+	foo.swap(bar);
+	bar['z'] = 300;
+
+	std::cout << "foo contains:" << std::endl;
+	for ( COMPACT_MAP<char, int>::iterator it = foo.begin(); it != foo.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+	std::cout << "bar contains:" << std::endl;
+	for ( COMPACT_MAP<char, int>::iterator it = bar.begin(); it != bar.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	COMPACT_MAP<char, int> empty;
+	empty.swap(foo);
+	std::cout << "foo is now " << (foo.begin() == foo.end() ? "empty" : "not empty") << std::endl;
+
+	return 0;
+}
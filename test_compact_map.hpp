@@ -0,0 +1,15 @@
+#ifndef TEST_COMPACT_MAP_HPP
+#define TEST_COMPACT_MAP_HPP
+
+int test_compact_map();
+int test_compact_map_begin();
+int test_compact_map_constructor();
+int test_compact_map_copy();
+int test_compact_map_erase();
+int test_compact_map_insert();
+int test_compact_map_lookup();
+int test_compact_map_rbegin();
+int test_compact_map_separate();
+int test_compact_map_swap();
+
+#endif /* TEST_COMPACT_MAP_HPP */
@@ -0,0 +1,277 @@
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+#include "test.h"
+#include "test_flat_map.hpp"
+
+// Like btree_map, any modification of a flat_map invalidates its iterators
+
+typedef FLAT_MAP<int, int> int_flat;
+
+static int const big = 5000;
+
+static void print_summary(int_flat const& table)
+{
+	long sum     = 0;
+	long ordered = 1;
+	int  prev    = 0;
+
+	for (int_flat::const_iterator it = table.begin(); it != table.end(); ++it)
+	{
+		if (it != table.begin() && !(prev < it->first))
+			ordered = 0;
+		prev = it->first;
+		sum += it->first * 3 + (*it).second;
+	}
+	std::cout << "size " << table.size() << " sum " << sum << " ordered " << ordered << std::endl;
+}
+
+// std::map has no insert_many, its range insert does the same thing
+template <typename InputIt>
+static void insert_many(std::map<int, int>& m, InputIt first, InputIt last)
+{
+	m.insert(first, last);
+}
+
+template <typename InputIt>
+static void insert_many(ft::flat_map<int, int>& m, InputIt first, InputIt last)
+{
+	m.insert_many(first, last);
+}
+
+// Reads pairs out of an array like a pointer would, but throws when it gets to fail
+struct failing_reader
+{
+	typedef std::input_iterator_tag          iterator_category;
+	typedef NAMESPACE::pair<int, int>        value_type;
+	typedef std::ptrdiff_t                   difference_type;
+	typedef value_type const*                pointer;
+	typedef value_type const&                reference;
+
+	pointer at;
+	pointer fail;
+
+	/*Constructor*/ failing_reader(pointer p, pointer f) : at(p), fail(f) { }
+
+	reference operator*() const
+	{
+		if (at == fail)
+			throw std::runtime_error("failing_reader");
+		return *at;
+	}
+	pointer operator->() const { return &**this; }
+	failing_reader& operator++() { ++at; return *this; }
+	bool operator==(failing_reader const& rhs) const { return at == rhs.at; }
+	bool operator!=(failing_reader const& rhs) const { return at != rhs.at; }
+};
+
+// What is left after a throw must still be sorted, and every key in it must be found
+static void print_consistency(int_flat const& table)
+{
+	int ordered = 1;
+	int found   = 1;
+
+	for (int_flat::const_iterator it = table.begin(); it != table.end(); ++it)
+	{
+		int_flat::const_iterator next = it;
+		if (++next != table.end() && !(it->first < next->first))
+			ordered = 0;
+		if (table.find(it->first) != it || table.find(it->first)->second != it->second)
+			found = 0;
+	}
+	std::cout << "ordered " << ordered << " found " << found << std::endl;
+}
+
+int test_flat_map()
+{
+	test_flat_map_begin();
+	test_flat_map_constructor();
+	test_flat_map_erase();
+	test_flat_map_insert();
+	test_flat_map_insert_many();
+	test_flat_map_lookup();
+	test_flat_map_swap();
+	return 0;
+}
+
+int	test_flat_map_begin()
+{
+	FLAT_MAP<char, int> table;
+
+	table['b'] = 100;
+	table['a'] = 200;
+	table['c'] = 300;
+
+	for ( FLAT_MAP<char, int>::iterator it = table.begin(); it != table.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	FLAT_MAP<char, int>::iterator it = table.begin();
+	it->second = 201;
+	(*++it).second += 1;
+	std::cout << "a " << table['a'] << " b " << table.at('b') << std::endl;
+	try
+	{
+		table.at('z');
+	}
+	catch (std::out_of_range const&)
+	{
+		std::cout << "at('z') threw out_of_range" << std::endl;
+	}
+
+	return 0;
+}
+
+int	test_flat_map_constructor()
+{
+	NAMESPACE::pair<int, int> unsorted[] = {
+		NAMESPACE::make_pair(8, 80), NAMESPACE::make_pair(3, 30), NAMESPACE::make_pair(5, 50),
+		NAMESPACE::make_pair(3, 31), NAMESPACE::make_pair(1, 10), NAMESPACE::make_pair(2, 20)
+	};
+	int_flat first(unsorted, unsorted + 6);
+	std::cout << "first contains " << first.size() << " elements:" << std::endl;
+	for ( int_flat::iterator it = first.begin(); it != first.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	int_flat copy(first);
+	copy[4] = 40;
+	first.erase(8);
+	print_summary(first);
+	print_summary(copy);
+	first = copy;
+	std::cout << "first == copy: " << (first == copy) << std::endl;
+
+	return 0;
+}
+
+int	test_flat_map_erase()
+{
+	int_flat table;
+
+	for (int i = 0; i < 64; ++i)
+		table[(i * 37) % 64] = i;
+	for (int i = 0; i < 64; i += 3)
+		std::cout << "erase(" << i << ") returned " << table.erase(i) << std::endl;
+	std::cout << "erase(3) again returned " << table.erase(3) << std::endl;
+	table.erase(table.find(10));
+	table.erase(table.find(20), table.find(50));
+	for ( int_flat::iterator it = table.begin(); it != table.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+	table.clear();
+	std::cout << "cleared: " << table.size() << " " << (table.begin() == table.end()) << std::endl;
+
+	return 0;
+}
+
+int	test_flat_map_insert()
+{
+	int_flat table;
+	NAMESPACE::pair<int_flat::iterator, bool> ret;
+
+	ret = table.insert(NAMESPACE::make_pair(10, 100));
+	std::cout << "inserted " << ret.first->first << ": " << ret.second << std::endl;
+	ret = table.insert(NAMESPACE::make_pair(10, 200));
+	std::cout << "inserted " << ret.first->first << "=>" << ret.first->second << ": " << ret.second << std::endl;
+	for (int i = big; i > 0; --i)
+		table.insert(table.end(), NAMESPACE::make_pair((i * 7) % big, i));
+	print_summary(table);
+
+	return 0;
+}
+
+int	test_flat_map_insert_many()
+{
+	int_flat table;
+	NAMESPACE::pair<int, int> batch[] = {
+		NAMESPACE::make_pair(9, 90), NAMESPACE::make_pair(4, 40), NAMESPACE::make_pair(9, 91),
+		NAMESPACE::make_pair(0, 0), NAMESPACE::make_pair(4, 41), NAMESPACE::make_pair(6, 60)
+	};
+
+	insert_many(table, batch, batch + 6);
+	for ( int_flat::iterator it = table.begin(); it != table.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	// Keys already in the table keep their value
+	NAMESPACE::pair<int, int> more[] = {
+		NAMESPACE::make_pair(5, 50), NAMESPACE::make_pair(4, 42), NAMESPACE::make_pair(10, 100),
+		NAMESPACE::make_pair(-1, -10), NAMESPACE::make_pair(5, 51)
+	};
+	insert_many(table, more, more + 5);
+	insert_many(table, more, more);
+	for ( int_flat::iterator it = table.begin(); it != table.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	static NAMESPACE::pair<int, int> load[big];
+	for (int i = 0; i < big; ++i)
+		load[i] = NAMESPACE::make_pair((i * 7919) % (big * 2), i);
+	insert_many(table, load, load + big);
+	print_summary(table);
+	insert_many(table, load + big / 2, load + big);
+	print_summary(table);
+
+	// New keys, out of order, the fourth one can't be read
+	NAMESPACE::pair<int, int> unread[] = {
+		NAMESPACE::make_pair(big * 4, 1), NAMESPACE::make_pair(-big, 2), NAMESPACE::make_pair(big * 3, 3),
+		NAMESPACE::make_pair(-2 * big, 4), NAMESPACE::make_pair(big * 5, 5)
+	};
+	try
+	{
+		insert_many(table, failing_reader(unread, unread + 3), failing_reader(unread + 5, unread + 3));
+	}
+	catch (std::runtime_error const& e)
+	{
+		std::cout << "insert_many threw " << e.what() << std::endl;
+	}
+	print_consistency(table);
+
+	return 0;
+}
+
+int	test_flat_map_lookup()
+{
+	int_flat table;
+
+	for (int i = 0; i < big; ++i)
+		table[i * 3] = i;
+
+	int_flat const& ctable = table;
+	int probes[] = { -1, 0, 1, 2, 3, 299, 300, 301, 7499, 14997, 14998, 20000 };
+	for (unsigned i = 0; i < sizeof(probes) / sizeof(*probes); ++i)
+	{
+		int k = probes[i];
+		int_flat::const_iterator lo = ctable.lower_bound(k);
+		int_flat::iterator       hi = table.upper_bound(k);
+		std::cout << k << ": count " << table.count(k)
+		          << " find " << (table.find(k) == table.end() ? -1 : table.find(k)->second)
+		          << " lower " << (lo == ctable.end() ? -1 : lo->first)
+		          << " upper " << (hi == table.end() ? -1 : hi->first)
+		          << " range " << (table.equal_range(k).first != table.equal_range(k).second) << std::endl;
+	}
+
+	return 0;
+}
+
+int	test_flat_map_swap()
+{
+	FLAT_MAP<char, int> foo, bar;
+
+	foo['x'] = 100;
+	foo['y'] = 200;
+	bar['a'] = 11;
+	bar['b'] = 22;
+	bar['c'] = 33;
+
+	foo.swap(bar);
+	bar['z'] = 300;
+
+	std::cout << "foo contains:" << std::endl;
+	for ( FLAT_MAP<char, int>::iterator it = foo.begin(); it != foo.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+	std::cout << "bar contains:" << std::endl;
+	for ( FLAT_MAP<char, int>::iterator it = bar.begin(); it != bar.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	return 0;
+}
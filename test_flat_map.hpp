@@ -0,0 +1,13 @@
+#ifndef TEST_FLAT_MAP_HPP
+#define TEST_FLAT_MAP_HPP
+
+int test_flat_map();
+int test_flat_map_begin();
+int test_flat_map_constructor();
+int test_flat_map_erase();
+int test_flat_map_insert();
+int test_flat_map_insert_many();
+int test_flat_map_lookup();
+int test_flat_map_swap();
+
+#endif /* TEST_FLAT_MAP_HPP */
@@ -1,38 +1,95 @@
+#include <algorithm>
+#include <cstddef>
 #include <exception>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#if __cplusplus >= 201103L
+# include <thread>
+#endif
 
 #include "test.h"
 #include "test_map.hpp"
+#include "test_map_shims.hpp"
 
 int test_map()
 {
+	test_map_aggregate();
 	test_map_begin();
 	test_map_clear();
-	/*test( test_map_constructor() )*/
+	test_map_constructor();
+	test_map_copy();
 	/*test( test_map_count() )*/
 	/*test( test_map_empty() )*/
 	/*test( test_map_end() )*/
 	/*test( test_map_equal_range() )*/
-	/*test( test_map_erase() )*/
+	test_map_erase();
+	test_map_erase_if();
+	test_map_extract_merge();
 	/*test( test_map_find() )*/
+	test_map_find_batch();
+	test_map_finger_search();
 	/*test( test_map_get_allocator() )*/
-	/*test( test_map_insert() )*/
+	test_map_get_or_insert();
+	test_map_insert();
 	/*test( test_map_key_comp() )*/
 	/*test( test_map_lower_bound() )*/
-	/*test( test_map_operator_bracket() )*/
+	test_map_operator_bracket();
 	/*test( test_map_operator_equal() )*/
-	/*test( test_map_rbegin() )*/
+	test_map_order_statistics();
+	test_map_rbegin();
 	/*test( test_map_relational_operators() )*/
 	/*test( test_map_rend() )*/
+	test_map_set_operations();
 	/*test( test_map_size() )*/
-	/*test( test_map_swap() )*/
+	test_map_split_join();
+	test_map_string_keys();
+	test_map_swap();
 	/*test( test_map_swap_overload() )*/
 	/*test( test_map_tags() )*/
+	test_map_three_way();
 	/*test( test_map_upper_bound() )*/
 	/*test( test_map_value_comp() )*/
 	return 0;
 }
 
+typedef SUMMED_INT_MAP summed_map;
+
+static void print_int_map(char const *name, NAMESPACE::map<int, int> const& m);
+
+int	test_map_aggregate()
+{
+	summed_map tree;
+
+	for (int i = 0; i < 1000; ++i)
+		tree[(i * 37) % 1000] = i;
+	for (int i = 0; i < 1000; ++i)
+		refresh(tree, tree.find(i)); // operator[] wrote the values behind the map's back
+	for (int i = 0; i < 1000; i += 3)
+		tree.erase((i * 7) % 1000);
+	tree.insert(NAMESPACE::make_pair(-5, 1000000));
+	summed_map::iterator it = tree.find(500);
+	it->second = -500;
+	refresh(tree, it);
+
+	int ranges[][2] = { { 0, 1000 }, { -10, 2000 }, { 100, 200 }, { 499, 501 }, { 500, 500 }, { 700, 300 }, { 999, 1000 } };
+	for (unsigned i = 0; i < sizeof(ranges) / sizeof(*ranges); ++i)
+		std::cout << "sum [" << ranges[i][0] << ", " << ranges[i][1] << ") = "
+		          << sum_range(tree, ranges[i][0], ranges[i][1]) << std::endl;
+
+	// set_value() keeps the aggregates up to date by itself, no refresh() after it
+	set_value(tree, tree.find(1), 7);
+	set_value(tree, tree.find(999), -1);
+	set_value(tree, tree.begin(), 5);
+	std::cout << "total " << total(tree) << ", sum [-5, 2) = " << sum_range(tree, -5, 2)
+	          << ", sum [990, 1000) = " << sum_range(tree, 990, 1000) << std::endl;
+
+	return 0;
+}
+
 int	test_map_begin()
 {
 	map<char, int> tree;
@@ -72,8 +129,93 @@ int	test_map_clear()
 	return 0;
 }
 
+// Counts how many of it are alive and throws from the copy it is told to
+struct fragile
+{
+	static int live;
+	static int copies_left; // The copy made when it is 0 throws, never when negative
+
+	int value;
+
+	/*Constructor*/ fragile(int v) : value(v) { ++live; }
+	/*Copy Constructor*/ fragile(fragile const& other) : value(other.value)
+	{
+		if (copies_left >= 0 && copies_left-- == 0)
+			throw std::runtime_error("fragile copy");
+		++live;
+	}
+	/*Destructor*/ ~fragile() { --live; }
+
+	fragile& operator=(fragile const& other)
+	{
+		value = other.value;
+		return *this;
+	}
+};
+
+int fragile::live        = 0;
+int fragile::copies_left = -1;
+
+// Builds a map out of [first, last) with the copy of the nth element throwing
+static void build_fragile(char const *name, NAMESPACE::pair<int, fragile> const *first,
+                          NAMESPACE::pair<int, fragile> const *last, int n)
+{
+	int before = fragile::live;
+
+	fragile::copies_left = n;
+	try
+	{
+		NAMESPACE::map<int, fragile> m(first, last);
+		std::cout << name << " built " << m.size() << " elements" << std::endl;
+	}
+	catch (std::runtime_error const& e)
+	{
+		std::cout << name << " threw " << e.what() << ", " << fragile::live - before << " left alive" << std::endl;
+	}
+	fragile::copies_left = -1;
+}
+
 int	test_map_constructor()
 {
+	NAMESPACE::pair<int, int> sorted[] = {
+		NAMESPACE::make_pair(1, 10), NAMESPACE::make_pair(2, 20), NAMESPACE::make_pair(2, 21),
+		NAMESPACE::make_pair(3, 30), NAMESPACE::make_pair(5, 50), NAMESPACE::make_pair(8, 80)
+	};
+	NAMESPACE::pair<int, int> unsorted[] = {
+		NAMESPACE::make_pair(8, 80), NAMESPACE::make_pair(3, 30), NAMESPACE::make_pair(5, 50),
+		NAMESPACE::make_pair(3, 31), NAMESPACE::make_pair(1, 10), NAMESPACE::make_pair(2, 20)
+	};
+
+	NAMESPACE::map<int, int> first(sorted, sorted + 6);
+	std::cout << "first contains " << first.size() << " elements:" << std::endl;
+	for ( NAMESPACE::map<int, int>::iterator it = first.begin(); it != first.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	NAMESPACE::map<int, int> second(unsorted, unsorted + 6);
+	std::cout << "second contains " << second.size() << " elements:" << std::endl;
+	for ( NAMESPACE::map<int, int>::iterator it = second.begin(); it != second.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	NAMESPACE::map<int, int> third(first.find(2), first.end());
+	third.insert(unsorted, unsorted + 6);
+	std::cout << "third contains " << third.size() << " elements:" << std::endl;
+	for ( NAMESPACE::map<int, int>::iterator it = third.begin(); it != third.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	// Nodes built before a copy throws are destroyed, none of them outlive the constructor
+	NAMESPACE::pair<int, fragile> in_order[] = {
+		NAMESPACE::make_pair(1, fragile(1)), NAMESPACE::make_pair(2, fragile(2)), NAMESPACE::make_pair(3, fragile(3)),
+		NAMESPACE::make_pair(5, fragile(5)), NAMESPACE::make_pair(8, fragile(8))
+	};
+	NAMESPACE::pair<int, fragile> shuffled[] = {
+		NAMESPACE::make_pair(8, fragile(8)), NAMESPACE::make_pair(3, fragile(3)), NAMESPACE::make_pair(5, fragile(5)),
+		NAMESPACE::make_pair(1, fragile(1)), NAMESPACE::make_pair(2, fragile(2))
+	};
+	build_fragile("sorted, 4th copy", in_order, in_order + 5, 3);
+	build_fragile("sorted, 1st copy", in_order, in_order + 5, 0);
+	build_fragile("unsorted, 5th copy", shuffled, shuffled + 5, 4);
+	build_fragile("unsorted, no throw", shuffled, shuffled + 5, -1);
+
 	return 0;
 }
 
@@ -101,8 +243,191 @@ int	test_map_equal_range()
 	return 0;
 }
 
+int	test_map_copy()
+{
+	NAMESPACE::map<int, int> m;
+
+	for (int i = 0; i < 1000; ++i)
+		m[(i * 37) % 1000] = i;
+	for (int i = 0; i < 1000; i += 7)
+		m.erase(i);
+
+	NAMESPACE::map<int, int> copy(m);
+	m.erase(5);
+	copy[-1] = -1;
+	print_int_map("original", m);
+	print_int_map("copy", copy);
+
+	NAMESPACE::map<int, int> assigned;
+	assigned[42] = 42;
+	assigned = copy;
+	assigned = assigned;
+	print_int_map("assigned", assigned);
+	std::cout << "copy == assigned: " << (copy == assigned) << ", m < copy: " << (m < copy) << std::endl;
+
+	NAMESPACE::map<int, int> const empty;
+	assigned = empty;
+	NAMESPACE::map<int, int> empty_copy(empty);
+	print_int_map("assigned empty", assigned);
+	print_int_map("empty copy", empty_copy);
+
+	// The copy's elements are its own
+	NAMESPACE::map<std::string, std::string> names;
+	names["one"] = "uno";
+	names["two"] = "dos";
+	NAMESPACE::map<std::string, std::string> other_names(names);
+	other_names["one"] += "!";
+	names = other_names;
+	other_names.clear();
+	for (NAMESPACE::map<std::string, std::string>::iterator it = names.begin(); it != names.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	return 0;
+}
+
 int	test_map_erase()
 {
+	NAMESPACE::map<int, int> myMap;
+
+	for (int i = 0; i < 64; ++i)
+		myMap[(i * 37) % 64] = i;
+	for (int i = 0; i < 64; i += 3)
+		std::cout << "erase(" << i << ") returned " << myMap.erase(i) << std::endl;
+	std::cout << "erase(3) again returned " << myMap.erase(3) << std::endl;
+	myMap.erase(myMap.find(10));
+
+	// Iterators to the other elements must survive an erase
+	NAMESPACE::map<int, int>::iterator kept = myMap.find(40);
+	myMap.erase(myMap.find(32));
+	myMap.erase(myMap.find(41));
+	std::cout << "kept " << kept->first << "=>" << kept->second << std::endl;
+
+	std::cout << "myMap contains " << myMap.size() << " elements:" << std::endl;
+	for ( NAMESPACE::map<int, int>::iterator it = myMap.begin(); it != myMap.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	myMap.erase(myMap.find(20), myMap.find(50));
+	std::cout << "after range erase, myMap contains " << myMap.size() << " elements:" << std::endl;
+	for ( NAMESPACE::map<int, int>::iterator it = myMap.begin(); it != myMap.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	// Ranges big enough for the cut to go through many levels, iterators outside them stay valid
+	NAMESPACE::map<int, int> big;
+	for (int i = 0; i < 5000; ++i)
+		big[(i * 7919) % 5000] = i;
+	NAMESPACE::map<int, int>::iterator low  = big.find(999);
+	NAMESPACE::map<int, int>::iterator high = big.find(4000);
+	big.erase(big.find(1000), high);
+	std::cout << "erase_range(100, 900) returned " << erase_range(big, 100, 900) << std::endl;
+	std::cout << "erase_range(900, 100) returned " << erase_range(big, 900, 100) << std::endl;
+	std::cout << "erase_range(500, 600) returned " << erase_range(big, 500, 600) << std::endl;
+	std::cout << "erase_range(4990, 6000) returned " << erase_range(big, 4990, 6000) << std::endl;
+	std::cout << "kept " << low->first << "=>" << low->second << ", " << high->first << "=>" << high->second << std::endl;
+	big.erase(big.find(4500), big.end());
+	big.erase(big.begin(), big.find(50));
+	big.erase(big.find(60), big.find(60));
+	long sum = 0;
+	for (NAMESPACE::map<int, int>::reverse_iterator it = big.rbegin(); it != big.rend(); ++it)
+		sum += it->first * 3 + it->second;
+	std::cout << "big: " << big.size() << " " << sum << " " << big.begin()->first << " " << big.rbegin()->first << std::endl;
+	std::cout << "erase_range(-1, 10000) returned " << erase_range(big, -1, 10000) << ", empty " << big.empty() << std::endl;
+	big[1] = 1;
+	std::cout << "refilled: " << big.begin()->first << " " << big.size() << std::endl;
+
+	return 0;
+}
+
+// Bytes the maps using it hold from the allocator right now
+static long counted_bytes = 0;
+
+template <typename T>
+struct counting_allocator : std::allocator<T>
+{
+	template <typename U>
+	struct rebind
+	{
+		typedef counting_allocator<U> other;
+	};
+
+	/*Default Constructor*/ counting_allocator() { }
+
+	template <typename U>
+	/*Conversion*/ counting_allocator(counting_allocator<U> const&) { }
+
+	T *allocate(std::size_t n)
+	{
+		counted_bytes += static_cast<long>(n * sizeof(T));
+		return std::allocator<T>::allocate(n);
+	}
+
+	void deallocate(T *p, std::size_t n)
+	{
+		counted_bytes -= static_cast<long>(n * sizeof(T));
+		std::allocator<T>::deallocate(p, n);
+	}
+};
+
+typedef NAMESPACE::map<int, int, std::less<int>, counting_allocator<std::pair<const int, int> > > counted_alloc_map;
+
+// Staging fills up and is merged into live, round after round, with live either cleared before
+// each merge or cut back to 100 elements after it. What is held once the first rounds are over
+// must be enough for all of the others
+static void merge_rounds(char const *name, bool clear_live)
+{
+	counted_alloc_map live;
+	counted_alloc_map staging;
+	long              settled = 0;
+	long              most    = 0;
+
+	for (int round = 0; round < 40; ++round)
+	{
+		for (int i = 0; i < 1000; ++i)
+			staging[round * 1000 + i] = i;
+		if (clear_live)
+			live.clear();
+		merge_map(live, staging);
+		staging.clear();
+		while (live.size() > 100)
+			live.erase(live.begin());
+		if (round == 10)
+			settled = counted_bytes;
+		if (round >= 10 && counted_bytes > most)
+			most = counted_bytes;
+	}
+	std::cout << name << ": " << live.size() << " left, memory bounded " << (most <= 2 * settled) << std::endl;
+}
+
+int	test_map_extract_merge()
+{
+	NAMESPACE::map<int, int> live;
+	NAMESPACE::map<int, int> staging;
+
+	for (int i = 0; i < 100; ++i)
+		live[(i * 37) % 100] = i;
+	for (int i = 50; i < 150; i += 5)
+		staging[i] = -i;
+
+	std::cout << "move 55: " << move_entry(staging, 55, live) << ", move 140: " << move_entry(staging, 140, live)
+	          << ", move 7: " << move_entry(staging, 7, live) << std::endl;
+	std::cout << "rekey 42 to 420: " << rekey(live, 42, 420) << ", 1 to 2: " << rekey(live, 1, 2)
+	          << ", 3 to 3: " << rekey(live, 3, 3) << ", 1000 to 1: " << rekey(live, 1000, 1) << std::endl;
+	std::cout << "420 is " << live.find(420)->second << ", 140 is " << live.find(140)->second << std::endl;
+	adopt_from_temporary(live, -1, 1);
+	print_int_map("live", live);
+	print_int_map("staging", staging);
+
+	// Only the keys live does not have yet move
+	NAMESPACE::map<int, int>::iterator kept = live.find(10);
+	merge_map(live, staging);
+	print_int_map("merged", live);
+	print_int_map("left over", staging);
+	std::cout << "kept " << kept->first << "=>" << kept->second << ", 145 came along: " << live.find(145)->second << std::endl;
+	merge_map(staging, live);
+	print_int_map("back", staging);
+	print_int_map("emptied", live);
+
+	merge_rounds("merge into a cleared map", true);
+	merge_rounds("merge, then trim", false);
 
 	return 0;
 }
@@ -113,14 +438,145 @@ int	test_map_find()
 	return 0;
 }
 
+int	test_map_find_batch()
+{
+	NAMESPACE::map<int, int>                 m;
+	NAMESPACE::map<int, int>::const_iterator found[200];
+	int                                      keys[200];
+
+	std::cout << "empty: " << (find_batch(m, keys, keys, found) == found) << std::endl;
+	keys[0] = 3;
+	find_batch(m, keys, keys + 1, found);
+	std::cout << "3 in empty: " << (found[0] == m.end()) << std::endl;
+
+	for (int i = 0; i < 1000; ++i)
+		m[(i * 37) % 1000 * 2] = i;
+	// More keys than a batch holds, some missing, some twice
+	for (int i = 0; i < 200; ++i)
+		keys[i] = (i * 7919) % 2100 - 50;
+	keys[199] = keys[0];
+	NAMESPACE::map<int, int>::const_iterator *end = find_batch(m, keys, keys + 200, found);
+	long sum     = 0;
+	int  missing = 0;
+	for (NAMESPACE::map<int, int>::const_iterator *it = found; it != end; ++it)
+	{
+		if (*it == m.end())
+			++missing;
+		else
+			sum += (*it)->first * 3 + (*it)->second;
+	}
+	std::cout << "found " << (end - found - missing) << " missing " << missing << " sum " << sum << std::endl;
+	std::cout << keys[10] << " => " << (found[10] == m.end() ? -1 : found[10]->second) << std::endl;
+
+	return 0;
+}
+
+int	test_map_finger_search()
+{
+	NAMESPACE::map<int, int> m;
+
+	for (int i = 0; i < 1000; ++i)
+		m[(i * 37) % 1000 * 3] = i;
+
+	// Fingers near and far, before and after the answer, and end()
+	NAMESPACE::map<int, int>::iterator fingers[] = { m.begin(), m.find(1500), m.find(2997), m.end() };
+	int                                keys[]    = { -5, 0, 1, 1499, 1500, 1501, 2996, 2997, 4000 };
+	for (unsigned f = 0; f < sizeof(fingers) / sizeof(*fingers); ++f)
+	{
+		for (unsigned k = 0; k < sizeof(keys) / sizeof(*keys); ++k)
+		{
+			NAMESPACE::map<int, int>::iterator lb    = lower_bound_from(m, fingers[f], keys[k]);
+			NAMESPACE::map<int, int>::iterator found = find_from(m, fingers[f], keys[k]);
+			std::cout << (lb == m.end() ? -1 : lb->first) << "/" << (found == m.end() ? -1 : found->second) << " ";
+		}
+		std::cout << std::endl;
+	}
+
+	int                                      sorted[300];
+	NAMESPACE::map<int, int>::const_iterator found[300];
+	for (int i = 0; i < 300; ++i)
+		sorted[i] = i * 11 - 100;
+	find_sorted_batch(m, sorted, sorted + 300, found);
+	long sum = 0;
+	for (int i = 0; i < 300; ++i)
+		sum += found[i] == m.end() ? -1 : found[i]->second;
+	std::cout << "sorted batch sum " << sum << std::endl;
+
+	// New keys in between, some already there, then a few out of order
+	NAMESPACE::vector<NAMESPACE::pair<int, int> > values;
+	for (int i = 0; i < 500; ++i)
+		values.push_back(NAMESPACE::make_pair(i * 7 - 20, -i));
+	values.push_back(NAMESPACE::make_pair(1, 1));
+	values.push_back(NAMESPACE::make_pair(-1000, 1000));
+	insert_sorted_batch(m, values.begin(), values.end());
+	print_int_map("inserted", m);
+
+	return 0;
+}
+
 int	test_map_get_allocator()
 {
 
 	return 0;
 }
 
+// Makes numbered labels, counting how many it was asked for
+struct label_factory
+{
+	int *made;
+
+	std::string operator()() const
+	{
+		++*made;
+		return std::string("label ") + static_cast<char>('0' + *made % 10);
+	}
+};
+
+int	test_map_get_or_insert()
+{
+	NAMESPACE::map<int, std::string> labels;
+	int                              made    = 0;
+	label_factory                    factory = { &made };
+
+	for (int i = 0; i < 1000; ++i)
+		get_or_insert(labels, (i * 37) % 50, factory) += ".";
+	std::cout << "made " << made << " labels for " << labels.size() << " keys" << std::endl;
+	std::cout << labels[0] << ", " << labels[49].size() << std::endl;
+	get_or_insert(labels, 10, factory) = "set";
+	std::cout << labels[10] << ", made " << made << std::endl;
+	std::cout << get_or_insert(labels, -5, factory) << ", made " << made << ", first " << labels.begin()->first << std::endl;
+
+	return 0;
+}
+
 int	test_map_insert()
 {
+	NAMESPACE::map<int, int> myMap;
+	NAMESPACE::pair<NAMESPACE::map<int, int>::iterator, bool> ret;
+
+	ret = myMap.insert(NAMESPACE::make_pair(10, 100));
+	std::cout << "inserted " << ret.first->first << ": " << ret.second << std::endl;
+	ret = myMap.insert(NAMESPACE::make_pair(10, 200));
+	std::cout << "inserted " << ret.first->first << "=>" << ret.first->second << ": " << ret.second << std::endl;
+
+	// Sorted ingest, good hints
+	NAMESPACE::map<int, int>::iterator hint = myMap.end();
+	for (int i = 20; i < 100; i += 2)
+		hint = myMap.insert(hint, NAMESPACE::make_pair(i, i));
+	for (int i = 0; i < 10; ++i)
+		myMap.insert(myMap.end(), NAMESPACE::make_pair(200 + i, i));
+	hint = myMap.find(50);
+	myMap.insert(hint, NAMESPACE::make_pair(49, -49));
+	myMap.insert(hint, NAMESPACE::make_pair(51, -51));
+	// Bad hints and already present keys
+	myMap.insert(myMap.begin(), NAMESPACE::make_pair(150, 150));
+	myMap.insert(myMap.end(), NAMESPACE::make_pair(5, 5));
+	hint = myMap.insert(myMap.find(60), NAMESPACE::make_pair(30, -1));
+	std::cout << "hinted insert returned " << hint->first << "=>" << hint->second << std::endl;
+
+	std::cout << "myMap contains " << myMap.size() << " elements:" << std::endl;
+	for ( NAMESPACE::map<int, int>::iterator it = myMap.begin(); it != myMap.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
 
 	return 0;
 }
@@ -139,6 +595,19 @@ int	test_map_lower_bound()
 
 int	test_map_operator_bracket()
 {
+	// Counting, most keys are already there
+	NAMESPACE::map<int, int> counts;
+	for (int i = 0; i < 10000; ++i)
+		counts[(i * 7919) % 100] += 1;
+	counts[-1];
+	std::cout << "counts: " << counts.size() << " " << counts[0] << " " << counts[99] << " " << counts[-1] << std::endl;
+
+	NAMESPACE::map<std::string, std::string> words;
+	char const *text[] = { "to", "be", "or", "not", "to", "be" };
+	for (unsigned i = 0; i < sizeof(text) / sizeof(*text); ++i)
+		words[text[i]] += "*";
+	for (NAMESPACE::map<std::string, std::string>::iterator it = words.begin(); it != words.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
 
 	return 0;
 }
@@ -149,8 +618,118 @@ int	test_map_operator_equal()
 	return 0;
 }
 
+typedef COUNTED_INT_MAP counted_map;
+
+// Entries whose value, a timestamp, is older than now
+struct expired
+{
+	int now;
+
+	template <typename Pair>
+	bool operator()(Pair const& entry) const { return entry.second < now; }
+};
+
+// Keys that are a multiple of every
+struct multiple_of
+{
+	int every;
+
+	template <typename Pair>
+	bool operator()(Pair const& entry) const { return entry.first % every == 0; }
+};
+
+// A few matches get erased one by one, many have the tree rebuilt out of the survivors
+int	test_map_erase_if()
+{
+	COUNTED_INT_MAP tree;
+
+	for (int i = 0; i < 5000; ++i)
+		tree[(i * 7919) % 5000] = i;
+	COUNTED_INT_MAP::iterator kept = tree.find(4001);
+
+	multiple_of few  = { 500 };
+	expired     old  = { 3000 };
+	multiple_of odd  = { 2 };
+	std::cout << "erased " << erase_matching(tree, few) << " multiples of 500, " << tree.size() << " left" << std::endl;
+	std::cout << "erased " << erase_matching(tree, old) << " older than 3000, " << tree.size() << " left" << std::endl;
+	std::cout << "kept " << kept->first << "=>" << kept->second << std::endl;
+	std::cout << "retain removed " << retain_matching(tree, odd) << ", " << tree.size() << " left" << std::endl;
+	std::cout << "rank(2500) " << rank(tree, 2500) << ", select(100) " << select(tree, 100)->first
+	          << ", count_range(1000, 2000) " << count_range(tree, 1000, 2000) << std::endl;
+	long sum = 0;
+	for (COUNTED_INT_MAP::reverse_iterator it = tree.rbegin(); it != tree.rend(); ++it)
+		sum += it->first * 3 + it->second;
+	std::cout << "sum " << sum << ", first " << tree.begin()->first << ", last " << tree.rbegin()->first << std::endl;
+
+	expired all = { 1 << 30 };
+	std::cout << "erased " << erase_matching(tree, all) << ", empty " << tree.empty() << std::endl;
+	std::cout << "erased " << erase_matching(tree, all) << " from the empty map" << std::endl;
+	tree[7] = 7;
+	std::cout << "refilled: " << tree.begin()->first << " " << tree.size() << std::endl;
+
+	return 0;
+}
+
+int	test_map_order_statistics()
+{
+	counted_map tree;
+
+	for (int i = 0; i < 1000; ++i)
+		tree[(i * 37) % 1000 * 2] = i;
+	for (int i = 0; i < 1000; i += 3)
+		tree.erase((i * 7) % 1000 * 2);
+
+	counted_map const& ctree = tree;
+	int keys[] = { -1, 0, 1, 2, 500, 501, 1337, 1998, 1999, 5000 };
+	for (unsigned i = 0; i < sizeof(keys) / sizeof(*keys); ++i)
+		std::cout << "rank(" << keys[i] << ") = " << rank(ctree, keys[i]) << std::endl;
+
+	std::size_t indices[] = { 0, 1, 100, 332, 665, 666, 667, 10000 };
+	for (unsigned i = 0; i < sizeof(indices) / sizeof(*indices); ++i)
+	{
+		counted_map::const_iterator it = select(ctree, indices[i]);
+		if (it == ctree.end())
+			std::cout << "select(" << indices[i] << ") = end" << std::endl;
+		else
+			std::cout << "select(" << indices[i] << ") = " << it->first << "=>" << it->second
+			          << " at " << index_of(ctree, it) << std::endl;
+	}
+	std::cout << "[100, 1100) holds " << count_range(ctree, 100, 1100) << std::endl;
+	std::cout << "[1100, 100) holds " << count_range(ctree, 1100, 100) << std::endl;
+	std::cout << "end() is at " << index_of(ctree, ctree.end()) << " of " << tree.size() << std::endl;
+
+	return 0;
+}
+
 int	test_map_rbegin()
 {
+	NAMESPACE::map<int, int> myMap;
+
+	for (int i = 0; i < 32; ++i)
+		myMap[(i * 7) % 32] = i;
+
+	std::cout << "myMap backwards:" << std::endl;
+	for ( NAMESPACE::map<int, int>::reverse_iterator it = myMap.rbegin(); it != myMap.rend(); ++it)
+		std::cout << it->first << "=>" << (*it).second << std::endl;
+
+	NAMESPACE::map<int, int>::const_reverse_iterator rit = myMap.rbegin();
+	rit++;
+	std::cout << "second to last: " << rit->first << std::endl;
+	NAMESPACE::map<int, int>::iterator last = myMap.end();
+	--last;
+	std::cout << "last: " << last->first << std::endl;
+
+	// rbegin() stands for end() - 1, whatever the last element is by the time it is read
+	NAMESPACE::map<int, int>                   small;
+	small[1] = 1;
+	small[2] = 2;
+	NAMESPACE::map<int, int>::reverse_iterator r = small.rbegin();
+	std::cout << "rbegin: " << r->first;
+	small[3] = 3;
+	std::cout << " " << r->first;
+	small.erase(3);
+	small.erase(2);
+	std::cout << " " << r->first << " " << (*r).second << std::endl;
 
 	return 0;
 }
@@ -167,14 +746,159 @@ int	test_map_rend()
 	return 0;
 }
 
+int	test_map_set_operations()
+{
+	NAMESPACE::map<int, int> evens;
+	NAMESPACE::map<int, int> thirds;
+	NAMESPACE::map<int, int> few;
+	NAMESPACE::map<int, int> out;
+	NAMESPACE::map<int, int> more;
+
+	for (int i = 0; i < 3000; i += 2)
+		evens[i] = i;
+	for (int i = 0; i < 3000; i += 3)
+		thirds[i] = -i;
+	few[-5] = 5;
+	few[6] = 6;
+	few[1500] = 1500;
+	few[9999] = 9999;
+
+	union_of(evens, thirds, out);
+	print_int_map("evens | thirds", out);
+	difference_of(thirds, evens, out);
+	print_int_map("thirds - evens", out);
+	union_of(few, out, more);
+	print_int_map("few | that", more);
+	print_int_map("evens untouched", evens);
+	union_of_moved(evens, thirds, out);
+	print_int_map("evens | thirds, moved in", out);
+	intersection_of_moved(evens, thirds, out);
+	print_int_map("evens & thirds, moved in", out);
+	difference_of_moved(thirds, evens, out);
+	print_int_map("thirds - evens, moved in", out);
+	intersection_with_itself_moved(few, more);
+	print_int_map("few & itself, moved in", more);
+
+	// In place, source ends up empty and its elements only move
+	NAMESPACE::map<int, int> copy(thirds.begin(), thirds.end());
+	unite_map(copy, few);
+	print_int_map("thirds | few", copy);
+	print_int_map("few", few);
+	std::cout << "kept 6: " << copy.find(6)->second << ", 9999 moved along: " << copy.find(9999)->second << std::endl;
+	intersect_map(copy, evens);
+	print_int_map("that & evens", copy);
+	print_int_map("evens", evens);
+	for (int i = 0; i < 3000; i += 4)
+		evens[i] = i;
+	subtract_map(evens, copy);
+	print_int_map("fourths - that", evens);
+	intersect_map(evens, few);
+	print_int_map("with nothing", evens);
+	subtract_map(copy, copy);
+	print_int_map("minus itself", copy);
+
+	return 0;
+}
+
 int	test_map_size()
 {
 
 	return 0;
 }
 
+static void print_int_map(char const *name, NAMESPACE::map<int, int> const& m)
+{
+	long sum = 0;
+
+	for (NAMESPACE::map<int, int>::const_iterator it = m.begin(); it != m.end(); ++it)
+		sum += it->first * 3 + it->second;
+	std::cout << name << ": size " << m.size();
+	if (!m.empty())
+		std::cout << " first " << m.begin()->first << " last " << (--m.end())->first;
+	std::cout << " sum " << sum << std::endl;
+}
+
+int	test_map_split_join()
+{
+	NAMESPACE::map<int, int> shard;
+	NAMESPACE::map<int, int> upper;
+	NAMESPACE::map<int, int> other;
+
+	for (int i = 0; i < 1000; ++i)
+		shard[(i * 37) % 1000] = i;
+
+	split_map(shard, 600, upper);
+	print_int_map("lower", shard);
+	print_int_map("upper", upper);
+	std::cout << "700 moved along: " << upper.find(700)->second << std::endl;
+	split_map(upper, 5000, other);
+	split_map(shard, -1, other);
+	print_int_map("shard", shard);
+	print_int_map("other", other);
+
+	// The shards get used, then put back together in either order
+	other.erase(10);
+	other[599] = -599;
+	upper[1234] = 1234;
+	upper.erase(upper.begin());
+	join_map(upper, other);
+	print_int_map("joined", upper);
+	print_int_map("emptied", other);
+	join_map(other, upper);
+	print_int_map("back", other);
+	join_map(other, shard);
+	print_int_map("nothing new", other);
+
+#if __cplusplus >= 201103L
+	// A shard goes on in a thread of its own while the map it was cut from is destroyed
+	NAMESPACE::map<int, int> *whole = new NAMESPACE::map<int, int>;
+	NAMESPACE::map<int, int>  far;
+
+	for (int i = 0; i < 100000; ++i)
+		(*whole)[i] = i;
+	split_map(*whole, 50000, far);
+	std::thread user([&far]
+	{
+		for (int i = 50000; i < 100000; i += 2)
+			far.erase(i);
+		for (int i = 0; i < 20000; ++i)
+			far[200000 + i] = i;
+	});
+	delete whole;
+	user.join();
+
+	long sum = 0;
+	for (NAMESPACE::map<int, int>::iterator it = far.begin(); it != far.end(); ++it)
+		sum += it->second;
+	std::cout << "far shard: " << far.size() << " elements, sum " << sum << std::endl;
+#endif
+
+	return 0;
+}
+
 int	test_map_swap()
 {
+	NAMESPACE::map<char, int> foo, bar;
+
+	foo['x'] = 100;
+	foo['y'] = 200;
+	bar['a'] = 11;
+	bar['b'] = 22;
+	bar['c'] = 33;
+
+	foo.swap(bar);
+	bar['z'] = 300;
+
+	std::cout << "foo contains:" << std::endl;
+	for ( NAMESPACE::map<char, int>::iterator it = foo.begin(); it != foo.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+	std::cout << "bar contains:" << std::endl;
+	for ( NAMESPACE::map<char, int>::iterator it = bar.begin(); it != bar.end(); ++it)
+		std::cout << it->first << "=>" << it->second << std::endl;
+
+	NAMESPACE::map<char, int> empty;
+	empty.swap(foo);
+	std::cout << "foo is now " << (foo.begin() == foo.end() ? "empty" : "not empty") << std::endl;
 
 	return 0;
 }
@@ -191,6 +915,147 @@ int	test_map_tags()
 	return 0;
 }
 
+// Shorter strings first, then in text order
+struct shortlex_less
+{
+	bool operator()(std::string const& a, std::string const& b) const
+	{
+		if (a.size() != b.size())
+			return a.size() < b.size();
+		return a < b;
+	}
+};
+
+// What the maps use to compare shortlex keys once per node, it has to agree with shortlex_less
+namespace ft
+{
+template <>
+struct three_way_compare<shortlex_less>
+{
+	static int compare(shortlex_less const&, std::string const& a, std::string const& b)
+	{
+		if (a.size() != b.size())
+			return a.size() < b.size() ? -1 : 1;
+		return a.compare(b);
+	}
+};
+} // namespace ft
+
+template <typename Map>
+static void print_string_map(char const *name, Map const& m)
+{
+	std::cout << name << ":";
+	for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+		std::cout << " " << it->first << "=" << it->second;
+	std::cout << std::endl;
+}
+
+int	test_map_three_way()
+{
+	// Keys that only differ far into a long common prefix
+	NAMESPACE::map<std::string, int> paths;
+	std::string const                prefix = "/usr/share/doc/packages/";
+	for (int i = 0; i < 40; ++i)
+		paths[prefix + static_cast<char>('a' + (i * 7) % 26) + static_cast<char>('0' + i % 10)] = i;
+	paths.erase(prefix + "h1");
+	paths.erase(prefix + "zz");
+	std::cout << "paths: " << paths.size()
+	          << " count " << paths.count(prefix + "o2") << paths.count(prefix) << paths.count(prefix + "o2/")
+	          << " first " << paths.begin()->first << " last " << paths.rbegin()->first << std::endl;
+
+	// Extremes, where comparing by subtraction would overflow
+	NAMESPACE::map<long, int>     signed_keys;
+	NAMESPACE::map<unsigned, int> unsigned_keys;
+	long const                    longs[]     = { 0, -1, 1, 2147483647L, -2147483647L - 1, 42, -42 };
+	unsigned const                unsigneds[] = { 0, 1, 4294967295U, 2147483648U, 2147483647U, 7 };
+	for (int i = 0; i < 7; ++i)
+		signed_keys.insert(NAMESPACE::make_pair(longs[i], i));
+	for (int i = 0; i < 6; ++i)
+		unsigned_keys[unsigneds[i]] = i;
+	unsigned_keys.erase(2147483648U);
+	print_string_map("signed", signed_keys);
+	print_string_map("unsigned", unsigned_keys);
+	std::cout << "find " << signed_keys.find(-2147483647L - 1)->second << " " << (unsigned_keys.find(3) == unsigned_keys.end())
+	          << " " << unsigned_keys.find(4294967295U)->second << std::endl;
+
+	// A user comparator with its own specialization
+	NAMESPACE::map<std::string, int, shortlex_less> words;
+	char const *const                                text[] = { "pear", "fig", "apple", "kiwi", "banana", "date", "plum", "fig", "lime" };
+	for (int i = 0; i < 9; ++i)
+		words.insert(NAMESPACE::make_pair(std::string(text[i]), i));
+	words.erase("kiwi");
+	words["apricot"] = 10;
+	print_string_map("shortlex", words);
+	std::cout << "count " << words.count("fig") << words.count("kiwi") << words.count("plum") << std::endl;
+
+	return 0;
+}
+
+// Bytes outside of printable ASCII as \xx, so that keys with NULs and high bytes can be told apart
+static std::string escaped(std::string const& s)
+{
+	static char const hex[] = "0123456789abcdef";
+	std::string       out;
+
+	for (std::string::size_type i = 0; i < s.size(); ++i)
+	{
+		unsigned char c = static_cast<unsigned char>(s[i]);
+		if (c >= ' ' && c < 127)
+			out += static_cast<char>(c);
+		else
+			out += std::string("\\") + hex[c >> 4] + hex[c & 15];
+	}
+	return out;
+}
+
+template <typename It, typename Map>
+static std::string key_at(It it, Map& m)
+{
+	return it == m.end() ? std::string("end") : escaped(it->first);
+}
+
+int	test_map_string_keys()
+{
+	// Keys around the 8 bytes that nodes keep for std::less, with NULs and bytes above 127
+	NAMESPACE::map<std::string, int> m;
+	std::string const                keys[] = {
+		"", "a", "ab", std::string("ab\0", 3), std::string("ab\0c", 4), "abc", "abcdefg", "abcdefgh",
+		std::string("abcdefgh\0", 9), "abcdefghi", "abcdefgi", "abcdefgh\xff", "\x80" "abc", "\xff", "\xff\xff\xff\xff\xff\xff\xff\xff\xff",
+		"zzzzzzzzzzzzzzzzzzzz", "zzzzzzzzzzzzzzzzzzz", "zzzzzzzzzzzzzzzzzzzza"
+	};
+	int const                        n = sizeof(keys) / sizeof(*keys);
+	for (int i = 0; i < n; ++i)
+		m[keys[i]] = i;
+	std::string const base = "https://example.com/items/";
+	for (int i = 0; i < 200; ++i)
+		m[base + static_cast<char>('0' + (i * 7) % 10) + static_cast<char>('a' + (i * 11) % 26) + "/" + static_cast<char>('0' + i % 10)] = i;
+	std::cout << "size " << m.size() << std::endl;
+	for (NAMESPACE::map<std::string, int>::iterator it = m.begin(); it != m.end() && it->first < "h"; ++it)
+		std::cout << " " << escaped(it->first) << "=" << it->second;
+	std::cout << std::endl;
+
+	// Lookups that stop next to keys they share most of their bytes with
+	std::string const probes[] = {
+		"", std::string("\0", 1), "ab", std::string("ab\0", 3), std::string("ab\0\0", 4), "abcdefgh", "abcdefgg",
+		"abcdefgh\x01", "abcdefgz", "\x7f", "\xfe", "\xff\xff", base, base + "5", base + "5z/", base + "5z/9", base + "~", "zzzzzzzzzzzzzzzzzzzz\xff"
+	};
+	for (unsigned i = 0; i < sizeof(probes) / sizeof(*probes); ++i)
+		std::cout << escaped(probes[i]) << ": count " << m.count(probes[i])
+		          << " lower " << key_at(m.lower_bound(probes[i]), m)
+		          << " upper " << key_at(m.upper_bound(probes[i]), m) << std::endl;
+
+	// Changing a key in a node handle, the node has to be found under its new key
+	std::cout << "rekey " << rekey(m, std::string("abcdefgh"), std::string("abcdefgh\x80"))
+	          << rekey(m, std::string("ab"), std::string("zz")) << rekey(m, std::string("zz"), std::string("a")) << std::endl;
+	std::cout << "found " << m.count("abcdefgh") << m.count("abcdefgh\x80") << m.count("ab") << m.count("zz")
+	          << " " << key_at(m.lower_bound("abcdefgh"), m) << std::endl;
+	m.erase(m.lower_bound(base + "5z/9"), m.upper_bound(base + "7"));
+	m.erase("\xff");
+	std::cout << "size " << m.size() << " " << key_at(m.lower_bound(base + "5"), m) << " " << key_at(--m.end(), m) << std::endl;
+
+	return 0;
+}
+
 int	test_map_upper_bound()
 {
 
@@ -2,28 +2,40 @@
 #define TEST_MAP_HPP
 
 int test_map();
+int test_map_aggregate();
 int test_map_begin();
 int test_map_clear();
 int test_map_constructor();
+int test_map_copy();
 int test_map_count();
 int test_map_empty();
 int test_map_end();
 int test_map_equal_range();
 int test_map_erase();
+int test_map_erase_if();
+int test_map_extract_merge();
 int test_map_find();
+int test_map_find_batch();
+int test_map_finger_search();
 int test_map_get_allocator();
+int test_map_get_or_insert();
 int test_map_insert();
 int test_map_key_comp();
 int test_map_lower_bound();
 int test_map_operator_bracket();
 int test_map_operator_equal();
+int test_map_order_statistics();
 int test_map_rbegin();
 int test_map_relational_operators();
 int test_map_rend();
+int test_map_set_operations();
 int test_map_size();
+int test_map_split_join();
+int test_map_string_keys();
 int test_map_swap();
 int test_map_swap_overload();
 int test_map_tags();
+int test_map_three_way();
 int test_map_upper_bound();
 int test_map_value_comp();
 
@@ -0,0 +1,550 @@
+#ifndef TEST_MAP_SHIMS_HPP
+#define TEST_MAP_SHIMS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <string>
+
+#include "test.h"
+
+// What the map tests ask for that std::map has no member for, one helper per operation
+// On the std side of the diff it gets the same answer out of what std::map has, on the ft side it calls the member
+// Only one side is compiled in each build, so that neither is left unused
+
+/*ORDER STATISTICS*/
+
+#if ON_STD_SIDE
+// std::map has none of these, it walks to get the same answers
+inline std::size_t rank(std::map<int, int> const& m, int key)
+{
+	return std::distance(m.begin(), m.lower_bound(key));
+}
+
+inline std::map<int, int>::const_iterator select(std::map<int, int> const& m, std::size_t i)
+{
+	std::map<int, int>::const_iterator it = m.begin();
+
+	for (; i > 0 && it != m.end(); --i)
+		++it;
+	return it;
+}
+
+inline std::size_t index_of(std::map<int, int> const& m, std::map<int, int>::const_iterator it)
+{
+	return std::distance(m.begin(), it);
+}
+
+inline std::size_t count_range(std::map<int, int> const& m, int lo, int hi)
+{
+	if (!(lo < hi))
+		return 0;
+	return std::distance(m.lower_bound(lo), m.lower_bound(hi));
+}
+#else
+template <typename Map>
+inline std::size_t rank(Map const& m, int key)
+{
+	return m.rank(key);
+}
+
+template <typename Map>
+inline typename Map::const_iterator select(Map const& m, std::size_t i)
+{
+	return m.select(i);
+}
+
+template <typename Map>
+inline std::size_t index_of(Map const& m, typename Map::const_iterator it)
+{
+	return m.index_of(it);
+}
+
+template <typename Map>
+inline std::size_t count_range(Map const& m, int lo, int hi)
+{
+	return m.count_range(lo, hi);
+}
+#endif
+
+/*AGGREGATES*/
+
+#if ON_STD_SIDE
+// std::map adds the values up one by one
+inline long sum_range(std::map<int, int> const& m, int lo, int hi)
+{
+	long sum = 0;
+
+	if (!(lo < hi))
+		return 0;
+	for (std::map<int, int>::const_iterator it = m.lower_bound(lo); it != m.lower_bound(hi); ++it)
+		sum += it->second;
+	return sum;
+}
+
+inline long total(std::map<int, int> const& m)
+{
+	long sum = 0;
+
+	for (std::map<int, int>::const_iterator it = m.begin(); it != m.end(); ++it)
+		sum += it->second;
+	return sum;
+}
+
+inline void refresh(std::map<int, int>&, std::map<int, int>::iterator)
+{
+}
+
+inline void set_value(std::map<int, int>&, std::map<int, int>::iterator it, int value)
+{
+	it->second = value;
+}
+#else
+template <typename Map>
+inline long sum_range(Map const& m, int lo, int hi)
+{
+	return m.aggregate(lo, hi);
+}
+
+template <typename Map>
+inline long total(Map const& m)
+{
+	return m.aggregate();
+}
+
+template <typename Map>
+inline void refresh(Map& m, typename Map::iterator it)
+{
+	m.refresh(it);
+}
+
+template <typename Map>
+inline void set_value(Map& m, typename Map::iterator it, int value)
+{
+	m.set_value(it, value);
+}
+#endif
+
+/*SPLIT AND JOIN*/
+
+#if ON_STD_SIDE
+// std::map copies the elements over
+inline void split_map(std::map<int, int>& m, int key, std::map<int, int>& upper)
+{
+	upper.clear();
+	upper.insert(m.lower_bound(key), m.end());
+	m.erase(m.lower_bound(key), m.end());
+}
+
+inline void join_map(std::map<int, int>& m, std::map<int, int>& other)
+{
+	m.insert(other.begin(), other.end());
+	other.clear();
+}
+#else
+template <typename Map>
+inline void split_map(Map& m, int key, Map& upper)
+{
+	m.split(key, upper);
+}
+
+template <typename Map>
+inline void join_map(Map& m, Map& other)
+{
+	m.join(other);
+}
+#endif
+
+/*SET OPERATIONS*/
+
+#if ON_STD_SIDE
+// std::map goes through the sorted range algorithms, which keep the first range's element too
+inline void unite_map(std::map<int, int>& m, std::map<int, int>& source)
+{
+	m.insert(source.begin(), source.end());
+	source.clear();
+}
+
+inline void intersect_map(std::map<int, int>& m, std::map<int, int>& source)
+{
+	std::map<int, int> result;
+
+	std::set_intersection(m.begin(), m.end(), source.begin(), source.end(),
+	                      std::inserter(result, result.end()), m.value_comp());
+	m.swap(result);
+	source.clear();
+}
+
+inline void subtract_map(std::map<int, int>& m, std::map<int, int>& source)
+{
+	std::map<int, int> result;
+
+	std::set_difference(m.begin(), m.end(), source.begin(), source.end(),
+	                    std::inserter(result, result.end()), m.value_comp());
+	m.swap(result);
+	source.clear();
+}
+
+inline void union_of(std::map<int, int> const& x, std::map<int, int> const& y, std::map<int, int>& out)
+{
+	out.clear();
+	std::set_union(x.begin(), x.end(), y.begin(), y.end(), std::inserter(out, out.end()), x.value_comp());
+}
+
+inline void difference_of(std::map<int, int> const& x, std::map<int, int> const& y, std::map<int, int>& out)
+{
+	out.clear();
+	std::set_difference(x.begin(), x.end(), y.begin(), y.end(), std::inserter(out, out.end()), x.value_comp());
+}
+
+inline void intersection_of(std::map<int, int> const& x, std::map<int, int> const& y, std::map<int, int>& out)
+{
+	out.clear();
+	std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::inserter(out, out.end()), x.value_comp());
+}
+
+// Same from operands that are given up
+inline void union_of_moved(std::map<int, int> x, std::map<int, int> y, std::map<int, int>& out)
+{
+	union_of(x, y, out);
+}
+
+inline void intersection_of_moved(std::map<int, int> x, std::map<int, int> y, std::map<int, int>& out)
+{
+	intersection_of(x, y, out);
+}
+
+inline void difference_of_moved(std::map<int, int> x, std::map<int, int> y, std::map<int, int>& out)
+{
+	difference_of(x, y, out);
+}
+
+inline void intersection_with_itself_moved(std::map<int, int> x, std::map<int, int>& out)
+{
+	out = x;
+}
+#else
+// The parallel ones only fork from C++11 on, with more than one hardware thread
+template <typename Map>
+inline void unite_map(Map& m, Map& source)
+{
+	m.unite(source, 64);
+}
+
+template <typename Map>
+inline void intersect_map(Map& m, Map& source)
+{
+	m.intersect(source);
+}
+
+template <typename Map>
+inline void subtract_map(Map& m, Map& source)
+{
+	m.subtract(source, 64);
+}
+
+template <typename Map>
+inline void union_of(Map const& x, Map const& y, Map& out)
+{
+	ft::map_union(x, y, out);
+}
+
+template <typename Map>
+inline void difference_of(Map const& x, Map const& y, Map& out)
+{
+	ft::map_difference(x, y, out, 16);
+}
+
+template <typename Map>
+inline void intersection_of(Map const& x, Map const& y, Map& out)
+{
+	ft::map_intersection(x, y, out);
+}
+
+// The operands are copies made for the call, from C++11 on they are moved in and not copied again
+#if __cplusplus >= 201103L
+# define GIVEN_UP(map) std::move(map)
+#else
+# define GIVEN_UP(map) map
+#endif
+
+template <typename Map>
+inline void union_of_moved(Map x, Map y, Map& out)
+{
+	ft::map_union(GIVEN_UP(x), GIVEN_UP(y), out);
+}
+
+template <typename Map>
+inline void intersection_of_moved(Map x, Map y, Map& out)
+{
+	ft::map_intersection(GIVEN_UP(x), GIVEN_UP(y), out, 16);
+}
+
+template <typename Map>
+inline void difference_of_moved(Map x, Map y, Map& out)
+{
+	ft::map_difference(GIVEN_UP(x), GIVEN_UP(y), out);
+}
+
+template <typename Map>
+inline void intersection_with_itself_moved(Map x, Map& out)
+{
+	ft::map_intersection(GIVEN_UP(x), GIVEN_UP(x), out);
+}
+
+#undef GIVEN_UP
+#endif
+
+/*NODE HANDLES*/
+
+#if ON_STD_SIDE
+// std::map only has node handles from C++17 on, the element gets copied over instead
+inline bool move_entry(std::map<int, int>& from, int key, std::map<int, int>& to)
+{
+	std::map<int, int>::iterator it = from.find(key);
+
+	if (it == from.end() || !to.insert(*it).second)
+		return false;
+	from.erase(it);
+	return true;
+}
+
+template <typename Key, typename Value>
+inline bool rekey(std::map<Key, Value>& m, Key const& old_key, Key const& new_key)
+{
+	if (m.count(new_key) || !m.count(old_key))
+		return false;
+	m[new_key] = m[old_key];
+	m.erase(old_key);
+	return true;
+}
+
+inline void adopt_from_temporary(std::map<int, int>& live, int key, int value)
+{
+	live.insert(std::make_pair(key, value));
+}
+
+template <typename Compare, typename Alloc>
+inline void merge_map(std::map<int, int, Compare, Alloc>& m, std::map<int, int, Compare, Alloc>& source)
+{
+	for (typename std::map<int, int, Compare, Alloc>::iterator it = source.begin(); it != source.end(); )
+	{
+		if (m.insert(*it).second)
+			source.erase(it++);
+		else
+			++it;
+	}
+}
+#else
+template <typename Map>
+inline bool move_entry(Map& from, int key, Map& to)
+{
+	if (to.count(key))
+		return false;
+	return to.insert(from.extract(key)).inserted;
+}
+
+template <typename Map>
+inline bool rekey(Map& m, typename Map::key_type const& old_key, typename Map::key_type const& new_key)
+{
+	if (m.count(new_key) || !m.count(old_key))
+		return false;
+
+	typename Map::node_type nh = m.extract(old_key);
+	nh.key() = new_key;
+#if __cplusplus >= 201103L
+	return m.insert(std::move(nh)).inserted;
+#else
+	return m.insert(nh).inserted;
+#endif
+}
+
+// The handle outlives the map its node came from
+template <typename Map>
+inline typename Map::node_type extract_from_temporary(int key, int value)
+{
+	Map staging;
+
+	staging[key] = value;
+	return staging.extract(staging.begin());
+}
+
+template <typename Map>
+inline void adopt_from_temporary(Map& live, int key, int value)
+{
+	live.insert(live.end(), extract_from_temporary<Map>(key, value));
+}
+
+template <typename Map>
+inline void merge_map(Map& m, Map& source)
+{
+	m.merge(source);
+}
+#endif
+
+/*BATCHED LOOKUPS*/
+
+#if ON_STD_SIDE
+// std::map looks them up one after the other
+template <typename It>
+inline It find_batch(std::map<int, int> const& m, int const *first, int const *last, It out)
+{
+	for (; first != last; ++first)
+		*out++ = m.find(*first);
+	return out;
+}
+#else
+template <typename Map, typename It>
+inline It find_batch(Map const& m, int const *first, int const *last, It out)
+{
+	return m.find_batch(first, last, out);
+}
+#endif
+
+/*FINGER SEARCH*/
+
+#if ON_STD_SIDE
+// std::map has no fingers, every search starts from the root
+inline std::map<int, int>::iterator lower_bound_from(std::map<int, int>& m, std::map<int, int>::iterator, int key)
+{
+	return m.lower_bound(key);
+}
+
+inline std::map<int, int>::iterator find_from(std::map<int, int>& m, std::map<int, int>::iterator, int key)
+{
+	return m.find(key);
+}
+
+template <typename It>
+inline It find_sorted_batch(std::map<int, int> const& m, int const *first, int const *last, It out)
+{
+	return find_batch(m, first, last, out);
+}
+
+template <typename InputIt>
+inline void insert_sorted_batch(std::map<int, int>& m, InputIt first, InputIt last)
+{
+	m.insert(first, last);
+}
+#else
+template <typename Map>
+inline typename Map::iterator lower_bound_from(Map& m, typename Map::iterator finger, int key)
+{
+	return m.lower_bound_from(finger, key);
+}
+
+template <typename Map>
+inline typename Map::iterator find_from(Map& m, typename Map::iterator finger, int key)
+{
+	return m.find_from(finger, key);
+}
+
+template <typename Map, typename It>
+inline It find_sorted_batch(Map const& m, int const *first, int const *last, It out)
+{
+	return m.find_sorted_batch(first, last, out);
+}
+
+template <typename Map, typename InputIt>
+inline void insert_sorted_batch(Map& m, InputIt first, InputIt last)
+{
+	m.insert_sorted_batch(first, last);
+}
+#endif
+
+/*RANGE ERASE*/
+
+#if ON_STD_SIDE
+// What ft::map::erase_range does, through iterators
+inline std::size_t erase_range(std::map<int, int>& m, int lo, int hi)
+{
+	if (!(lo < hi))
+		return 0;
+
+	std::map<int, int>::iterator first = m.lower_bound(lo);
+	std::map<int, int>::iterator last  = m.lower_bound(hi);
+	std::size_t                  n     = 0;
+
+	for (std::map<int, int>::iterator it = first; it != last; ++it)
+		++n;
+	m.erase(first, last);
+	return n;
+}
+#else
+template <typename Map>
+inline std::size_t erase_range(Map& m, int lo, int hi)
+{
+	return m.erase_range(lo, hi);
+}
+#endif
+
+/*ERASE IF AND RETAIN*/
+
+#if ON_STD_SIDE
+// std::erase_if only comes with C++20, and there is no retain
+template <typename Pred>
+inline std::size_t erase_matching(std::map<int, int>& m, Pred pred)
+{
+	std::size_t n = m.size();
+
+	for (std::map<int, int>::iterator it = m.begin(); it != m.end();)
+	{
+		if (pred(*it))
+			m.erase(it++);
+		else
+			++it;
+	}
+	return n - m.size();
+}
+
+template <typename Pred>
+inline std::size_t retain_matching(std::map<int, int>& m, Pred pred)
+{
+	std::size_t n = m.size();
+
+	for (std::map<int, int>::iterator it = m.begin(); it != m.end();)
+	{
+		if (!pred(*it))
+			m.erase(it++);
+		else
+			++it;
+	}
+	return n - m.size();
+}
+#else
+template <typename Map, typename Pred>
+inline std::size_t erase_matching(Map& m, Pred pred)
+{
+	return ft::erase_if(m, pred);
+}
+
+template <typename Map, typename Pred>
+inline std::size_t retain_matching(Map& m, Pred pred)
+{
+	return m.retain(pred);
+}
+#endif
+
+/*GET OR INSERT*/
+
+#if ON_STD_SIDE
+// std::map has no get_or_insert, lower_bound and a hinted insert do the same in two descents
+template <typename Factory>
+inline std::string& get_or_insert(std::map<int, std::string>& m, int key, Factory factory)
+{
+	std::map<int, std::string>::iterator it = m.lower_bound(key);
+
+	if (it == m.end() || key < it->first)
+		it = m.insert(it, std::make_pair(key, factory()));
+	return it->second;
+}
+#else
+template <typename Map, typename Factory>
+inline std::string& get_or_insert(Map& m, int key, Factory factory)
+{
+	return m.get_or_insert(key, factory);
+}
+#endif
+
+#endif /* TEST_MAP_SHIMS_HPP */
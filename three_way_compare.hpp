@@ -0,0 +1,54 @@
+#ifndef THREE_WAY_COMPARE_HPP
+#define THREE_WAY_COMPARE_HPP
+
+#include <functional>
+#include <string>
+
+#include "enable_if.hpp"
+#include "is_integral.hpp"
+
+namespace ft
+{
+
+//Tells the trees which way to go at a node with a single comparison.
+//compare(comp, a, b) is negative, zero or positive as a sorts before, with or after b.
+//The primary template asks comp, which takes a second call whenever a does not sort before b.
+//The specializations know what std::less means for integers and strings and get it in one go.
+//Specialize it for your own comparator to get the same, as long as both agree on the order.
+template <typename KeyCmpFn, typename Enable = void>
+struct three_way_compare
+{
+	template <typename A, typename B>
+	static int compare(KeyCmpFn const& comp, A const& a, B const& b)
+	{
+		if (comp(a, b))
+			return -1;
+		return comp(b, a) ? 1 : 0;
+	}
+};
+
+//Integers: both flags are computed, nothing to branch on
+template <typename T>
+struct three_way_compare<std::less<T>, typename enable_if<is_integral<T>::value>::type>
+{
+	static int compare(std::less<T> const&, T const& a, T const& b)
+	{
+		return static_cast<int>(b < a) - static_cast<int>(a < b);
+	}
+};
+
+//Strings: basic_string::compare is one pass over the common prefix, operator< is that pass plus a test
+template <typename CharT, typename Traits, typename Alloc>
+struct three_way_compare<std::less<std::basic_string<CharT, Traits, Alloc> > >
+{
+	typedef std::basic_string<CharT, Traits, Alloc> string_type;
+
+	static int compare(std::less<string_type> const&, string_type const& a, string_type const& b)
+	{
+		return a.compare(b);
+	}
+};
+
+} // namespace ft
+
+#endif /* THREE_WAY_COMPARE_HPP */
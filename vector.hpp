@@ -22,6 +22,9 @@
 #include <cstddef>
 #include <memory>
 #include <sstream>
+#if __cplusplus >= 201103L
+# include <utility>
+#endif
 
 namespace ft
 {
@@ -97,6 +100,39 @@ class vector
 		allocator_.deallocate(data_, capacity_);
 	}
 
+	// Shifts the elements from offset on n slots to the right, growing first if needed
+	// Position iterators do not survive the growth, hence the offset
+	// Returns the first of the n raw slots left behind
+	pointer open_gap_(size_type offset, size_type n)
+	{
+		if (size_ + n > capacity_)
+			reserve((size_ + n) * 2);
+		for (size_type i = size_; i > offset; --i)
+			relocate_(&data_[i - 1 + n], &data_[i - 1]);
+		size_ += n;
+		return data_ + offset;
+	}
+
+	// Growth policy for one more element
+	size_type next_capacity_() const
+	{
+		if (size_ == 0)
+			return 1;
+		return size_ * 2;
+	}
+
+	// Builds *src's replacement at dst and gets rid of *src, moving when the language lets us
+	void relocate_(pointer dst, pointer src)
+	{
+#if __cplusplus >= 201103L
+		std::allocator_traits<Alloc>::construct(allocator_, dst, std::move(*src));
+		std::allocator_traits<Alloc>::destroy(allocator_, src);
+#else
+		allocator_.construct(dst, *src);
+		allocator_.destroy(src);
+#endif
+	}
+
   public:
 	/** INTERFACE **/
 
@@ -104,15 +140,15 @@ class vector
 	// It is explicit because we won't allow anything to be converted implicity to an allocator
 	// to an allocator.
 	explicit vector(const allocator_type& alloc = allocator_type())
-		 : allocator_(alloc)
+		 : allocator_(alloc), data_(NULL), size_(0), capacity_(0)
 	{
-		assign(0, value_type());
+		// Nothing to allocate until the first element comes
 	}
 
 	// Fill constructor
 	// If a call is like "vector<Obj>(5));" and passes then the value of Obj() is passed by default
 	explicit vector(size_type n, const value_type& val = value_type(), const allocator_type& alloc = allocator_type())
-		: allocator_(alloc)
+		: allocator_(alloc), data_(NULL), size_(0), capacity_(0)
 	{
 		assign(n, val);
 	}
@@ -124,17 +160,45 @@ class vector
 	template <class InputIterator>
 	vector(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type(),
 	       typename enable_if<!is_integral<InputIterator>::value, void*>::type = 0)
-		: allocator_(alloc)
+		: allocator_(alloc), data_(NULL), size_(0), capacity_(0)
 	{
 		assign(first, last);
 	}
 
 	// Copy constructor. Shall perform deep copy using operator=
 	vector(const vector& other)
+		: allocator_(other.allocator_), data_(NULL), size_(0), capacity_(0)
 	{
 		this->operator=(other);
 	}
 
+#if __cplusplus >= 201103L
+	// Steals other's buffer, leaving it empty
+	vector(vector&& other)
+		: allocator_(std::move(other.allocator_)), data_(other.data_), size_(other.size_), capacity_(other.capacity_)
+	{
+		other.data_     = NULL;
+		other.size_     = 0;
+		other.capacity_ = 0;
+	}
+
+	vector& operator=(vector&& rhs)
+	{
+		if (this != &rhs)
+		{
+			destroy_data_();
+			deallocate_data_();
+			data_         = rhs.data_;
+			size_         = rhs.size_;
+			capacity_     = rhs.capacity_;
+			rhs.data_     = NULL;
+			rhs.size_     = 0;
+			rhs.capacity_ = 0;
+		}
+		return *this;
+	}
+#endif
+
 	// Destructor.
 	~vector()
 	{
@@ -153,7 +217,7 @@ class vector
 			if (rhs.size_ > capacity_) // If we don't have enough room, let's make some
 			{
 				deallocate_data_();
-				data_     = allocator_.allocate(rhs.size_ * sizeof(value_type));
+				data_     = allocator_.allocate(rhs.size_);
 				capacity_ = rhs.size_;
 			}
 			size_ = rhs.size_;
@@ -223,31 +287,12 @@ class vector
 	// Resize to a specific size
 	void resize(size_type n, value_type val = value_type()) // No deallocation here. This is not shrink_to_fit()
 	{
-		if (n > size_)
-		{
-			if (n > capacity_)
-			{
-				// Then put data in bigger container
-				pointer tmp = allocator_.allocate(n * sizeof(value_type));
-				for (size_type i = 0; i < size_; ++i)
-				{
-					allocator_.construct(&tmp[i], data_[i]);
-					allocator_.destroy(&data_[i]);
-				}
-				deallocate_data_();
-				data_ = tmp;
-			}
-			for (--size_; size_ < n; ++size_)
-				allocator_.construct(&data_[size_], val); 
-			capacity_ = size_;
-		}
-		else
-		{
-			for (--size_; size_ >= n; --size_)
-				allocator_.destroy(&data_[size_]);
-			++size_;
-			capacity_ = size_;
-		}
+		if (n > capacity_) // Then put data in bigger container
+			reserve(n);
+		for (; size_ < n; ++size_)
+			allocator_.construct(&data_[size_], val);
+		while (size_ > n)
+			allocator_.destroy(&data_[--size_]);
 	}
 
 	size_type capacity() const
@@ -269,12 +314,9 @@ class vector
 			throw std::length_error("vector::reserve");
 		else if (n > capacity_)
 		{
-			pointer tmp = allocator_.allocate(n * sizeof(value_type));
+			pointer tmp = allocator_.allocate(n);
 			for (size_type i = 0; i < size_; ++i)
-			{
-				allocator_.construct(&tmp[i], data_[i]);
-				allocator_.destroy(&data_[i]);
-			}
+				relocate_(&tmp[i], &data_[i]);
 			deallocate_data_();
 			data_     = tmp;
 			capacity_ = n;
@@ -328,6 +370,17 @@ class vector
 		return data_[size_ - 1];
 	}
 
+	// The elements are contiguous, this is where they start
+	pointer data()
+	{
+		return data_;
+	}
+
+	const_pointer data() const
+	{
+		return data_;
+	}
+
 	allocator_type get_allocator() const
 	{
 		return allocator_;
@@ -343,7 +396,7 @@ class vector
 		destroy_data_();
 		deallocate_data_();
 		size_     = std::distance(first, last);
-		data_     = allocator_.allocate(size_ * sizeof(value_type));
+		data_     = allocator_.allocate(size_);
 		capacity_ = size_;
 		for (size_type i = 0; i < size_; ++i)
 			allocator_.construct(&data_[i], first[i]);
@@ -355,7 +408,7 @@ class vector
 		destroy_data_();
 		deallocate_data_();
 		size_     = n;
-		data_     = allocator_.allocate(size_ * sizeof(value_type));
+		data_     = allocator_.allocate(size_);
 		capacity_ = size_;
 		;
 		for (size_type i = 0; i < size_; ++i)
@@ -366,11 +419,28 @@ class vector
 	void push_back(const value_type& val)
 	{
 		if (capacity_ == size_)
-			reserve(size_ * 2);
+			reserve(next_capacity_());
 		allocator_.construct(&data_[size_], val);
 		++size_;
 	}
 
+#if __cplusplus >= 201103L
+	void push_back(value_type&& val)
+	{
+		emplace_back(std::move(val));
+	}
+
+	// The element is built right in the buffer out of whatever its constructor takes
+	template <typename... Args>
+	void emplace_back(Args&&... args)
+	{
+		if (capacity_ == size_)
+			reserve(next_capacity_());
+		std::allocator_traits<Alloc>::construct(allocator_, &data_[size_], std::forward<Args>(args)...);
+		++size_;
+	}
+#endif
+
 	void pop_back()
 	{
 		--size_;
@@ -379,39 +449,25 @@ class vector
 
 	iterator insert(iterator position, const value_type& val)
 	{
+		size_type offset = position - begin();
 		insert(position, 1, val);
-		return position;
+		return iterator(data_ + offset);
 	}
 
 	void insert(iterator position, size_type n, const value_type& val)
 	{
-		pointer pos = &(*position);
-		size_type new_size = size_ + n;
-		if (new_size > capacity_)
-			reserve(new_size * 2);
-		for (; size_ < new_size; ++size_, ++pos)
-		{
-			allocator_.construct(pos + n,  data_[size_]);
-			allocator_.destroy(pos);
-			allocator_.construct(pos, val);
-		}
+		pointer pos = open_gap_(position - begin(), n);
+		for (size_type i = 0; i < n; ++i)
+			allocator_.construct(pos + i, val);
 	}
 
 	template <class InputIterator>
 	void insert(iterator position, InputIterator first, InputIterator last,
 	            typename enable_if<!is_integral<InputIterator>::value, int>::type = 0)
 	{
-		pointer pos = &(*position);
-		size_type distance = std::distance(first, last);
-		size_type new_size = size_ + distance;
-		if (new_size > capacity_)
-			reserve(new_size * 2);
-		for (; size_ < new_size; ++size_, ++pos, ++first)
-		{
-			allocator_.construct(pos + distance,  data_[size_]);
-			allocator_.destroy(pos);
+		pointer pos = open_gap_(position - begin(), std::distance(first, last));
+		for (; first != last; ++pos, ++first)
 			allocator_.construct(pos, *first);
-		}
 	}
 
 	iterator erase(iterator position)
@@ -423,40 +479,36 @@ class vector
 	// The behaviour for last < first is not specified
 	iterator erase(iterator first, iterator last)
 	{
-		iterator end = this->end();
-		if (first >= end)
-			return end;
-		if (first == last)
-			return last;
-		size_type distance = std::distance(first, last);
-		size_ -= distance;
-		for (; last < end; --distance, ++first, ++last)
-		{
-			allocator_.destroy(&(*first));
-			allocator_.construct(&(*first), *last);
-		}
-		for (; distance > 0; --distance, ++first)
+		pointer dst = data_ + (first - begin());
+		pointer src = data_ + (last - begin());
+		pointer end = data_ + size_;
+
+		if (dst == src)
+			return first;
+		for (; src != end; ++dst, ++src) // The tail slides over the erased elements
+			*dst = *src;
+		while (dst != end)
 		{
-			allocator_.destroy(&(*first));
+			allocator_.destroy(dst++);
+			--size_;
 		}
-		return (first); 
+		return first;
 	}
 
+	// Buffers change hands, no element gets copied
 	void swap(vector& x)
 	{
-		vector<T> tmp = *this;
-		*this         = x;
-		x             = tmp;
+		std::swap(allocator_, x.allocator_);
+		std::swap(data_, x.data_);
+		std::swap(size_, x.size_);
+		std::swap(capacity_, x.capacity_);
 	}
 
+	// Keeps the storage around for what comes next
 	void clear()
 	{
-		for (--size_; size_ >= 0; --size_)
-		{
-			allocator_.destroy(&data_[size_]);
-		}
-		++size_;
-		capacity_ = 0;
+		destroy_data_();
+		size_ = 0;
 	}
 };
 
@@ -466,10 +518,9 @@ bool operator==(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
 	if (lhs.size() != rhs.size())
 		return false;
 
-	typename vector<T, Alloc>::iterator lit  = lhs.begin();
-	typename vector<T, Alloc>::iterator lend = lhs.end();
-	typename vector<T, Alloc>::iterator rit  = rhs.begin();
-	typename vector<T, Alloc>::iterator rend = rhs.end();
+	typename vector<T, Alloc>::const_iterator lit  = lhs.begin();
+	typename vector<T, Alloc>::const_iterator lend = lhs.end();
+	typename vector<T, Alloc>::const_iterator rit  = rhs.begin();
 
 	while (lit != lend)
 	{
@@ -72,9 +72,9 @@ template <typename T>
 	}
 
 	// Random access requirement
-	reference operator[](int i) const
+	reference operator[](difference_type i) const
 	{
-		return (current_ + i);
+		return current_[i];
 	}
 	
 	/// INCREMENT OPERATORS
@@ -86,7 +86,7 @@ template <typename T>
 		return *this;
 	}
 
-	vector_iterator& operator++(int)
+	vector_iterator operator++(int)
 	{
 		vector_iterator tmp = *this;
 		++current_;
@@ -102,7 +102,7 @@ template <typename T>
 		return *this;
 	}
 
-	vector_iterator& operator--(int)
+	vector_iterator operator--(int)
 	{
 		vector_iterator tmp = *this;
 		--current_;
@@ -125,12 +125,13 @@ template <typename T>
 	//Pas le choix si tu veux faire marcher des expressions telles que (-3 -it)
 	friend vector_iterator operator+(difference_type i, const vector_iterator& it)
 	{
-		return vector_iterator(it.current__ + i);
+		return vector_iterator(it.current_ + i);
 	}
 
-	friend vector_iterator operator-(difference_type i, const vector_iterator& it)
+	// Distance between two iterators
+	difference_type operator-(const vector_iterator& rhs) const
 	{
-		return vector_iterator(it.current__ - i);
+		return current_ - rhs.current_;
 	}
  
 	vector_iterator operator+=(difference_type i)
@@ -148,20 +149,27 @@ template <typename T>
 	}
 
 	//Allow for const to non const comparisons
+	//Only declared here: defined in the class, every instantiation would define them again
 	template<typename RightIterator, typename LeftIterator>
-	friend bool operator==(const vector_iterator<RightIterator>& lhs, const vector_iterator<LeftIterator>& rhs)
-	{
-		return lhs.current_ == rhs.current_;
-	}
+	friend bool operator==(const vector_iterator<RightIterator>& lhs, const vector_iterator<LeftIterator>& rhs);
 
 	template<typename RightIterator, typename LeftIterator>
-	friend bool operator<(const vector_iterator<RightIterator>& lhs, const vector_iterator<LeftIterator>& rhs)
-	{
-		return lhs.current_ < rhs.current_;
-	}
+	friend bool operator<(const vector_iterator<RightIterator>& lhs, const vector_iterator<LeftIterator>& rhs);
 
 }; // class vector_iterator
 
+template<typename RightIterator, typename LeftIterator>
+bool operator==(const vector_iterator<RightIterator>& lhs, const vector_iterator<LeftIterator>& rhs)
+{
+	return lhs.current_ == rhs.current_;
+}
+
+template<typename RightIterator, typename LeftIterator>
+bool operator<(const vector_iterator<RightIterator>& lhs, const vector_iterator<LeftIterator>& rhs)
+{
+	return lhs.current_ < rhs.current_;
+}
+
 template<typename RightIterator, typename LeftIterator>
 bool operator!=(const vector_iterator<RightIterator>& lhs, const vector_iterator<LeftIterator>& rhs)
 {